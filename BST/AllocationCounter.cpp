@@ -0,0 +1,27 @@
+/*
+This implementation file replaces the global new and delete operators, so every allocation of the program is counted. New takes its memory from
+malloc and both forms of delete give it back with free. The operators live in their own file, so the compiler never inlines them into a function
+that calls new and delete and never reports the malloc and free inside them as a mismatched pair.
+*/
+
+#include "AllocationCounter.h" // This is a header file that contains the declaration of the allocation counter.
+#include <cstdlib> // This is a header file library that lets us allocate memory with malloc.
+#include <new> // This is a header file library that lets us replace the global new and delete operators.
+
+atomic<size_t> allocationCount{ 0 }; // This counter stores how many times the program has allocated memory with new.
+
+void* operator new(size_t size) { // This function replaces the global new operator, so allocations can be counted.
+	allocationCount.fetch_add(1, memory_order_relaxed); // Count the allocation.
+	if (void* memory = malloc(size == 0 ? 1 : size)) { // Allocate the memory.
+		return memory; // Return the memory.
+	}
+	throw bad_alloc(); // Report that there is no memory left.
+}
+
+void operator delete(void* memory) noexcept { // This function replaces the global delete operator to match the replaced new operator.
+	free(memory); // Free the memory.
+}
+
+void operator delete(void* memory, size_t) noexcept { // This function replaces the sized global delete operator to match the replaced new operator.
+	free(memory); // Free the memory.
+}
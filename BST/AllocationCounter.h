@@ -0,0 +1,13 @@
+/*
+This header file declares the allocation counter that the test program and the benchmark use to check how often the trees allocate memory. The
+counter is raised by the replacement of the global new operator in AllocationCounter.cpp, which a program gets by compiling that file together with
+its own sources.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <atomic> // This is a header file library that lets us work with counters that are safe to share between threads.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+extern atomic<size_t> allocationCount; // This counter stores how many times the program has allocated memory with new.
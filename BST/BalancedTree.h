@@ -0,0 +1,277 @@
+/*
+This header file defines the balancing core shared by the string tree in BinarySearchTree.h and the typed tree in TypedBinarySearchTree.h. Both trees
+support the same three balancing modes, so the rotations, the AVL and left-leaning red-black rebalancing and the iterative insert and remove paths
+are written once here, over the node type. A node only has to offer child(side), height and red; each tree passes in how a key compares with a node,
+how a new node is made and how a removed node is freed, because that is where the two trees differ.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <algorithm> // This is a header file library that lets us use algorithms such as max.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as int16_t.
+#include "TreeOptions.h" // This is a header file that contains the balancing modes and traversal orders shared by the trees.
+#include "TreeStatistics.h" // This is a header file that contains the statistics the trees keep when BST_ENABLE_STATS is defined.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+template <typename NodeType>
+class BalancedTree { // This class holds the root of a binary search tree and keeps it balanced in the selected mode. The string tree and the typed tree derive from it.
+protected: // This section contains members the derived trees use.
+	NodeType* root; // This pointer points to the root node of the tree.
+	BalanceMode mode; // This value stores the balancing strategy used by the tree.
+	size_t nodeCount; // This number stores how many nodes are in the tree.
+#ifdef BST_ENABLE_STATS
+	mutable StatisticsCounters counters; // This object counts the operations of the tree. Lookups are const, so it is mutable.
+#endif
+
+	static constexpr int maxPathLength = 130; // This is the longest search path a balanced tree can have. Neither an AVL tree nor a red-black tree of fewer than 2^64 nodes is more than 128 levels deep.
+
+	explicit BalancedTree(BalanceMode mode) : root(nullptr), mode(mode), nodeCount(0) {} // This is a constructor that creates an empty tree with the given balancing strategy.
+
+	template <typename Order, typename Create>
+	NodeType* insertNode(const Order& order, const Create& create, bool& added) { // This function inserts a node unless order finds its key already, and returns the node that holds the key. It does not recurse, so a long unbalanced path cannot overflow the stack.
+		NodeType** path[maxPathLength]; // Create a stack of the links on the search path, so they can be rebalanced from the bottom up. An unbalanced tree is never rebalanced, so its links are not stored.
+		int depth = 0; // Create a counter for the links on the stack.
+		NodeType** link = &root; // Start at the link to the root.
+		while (*link != nullptr) { // Walk down until the link is empty.
+			int comparison = order(*link); // Compare the key with the current node's key.
+			if (comparison == 0) { // If the key is already in the tree, the tree does not change.
+				added = false; // Report that no node was added.
+				BST_STATS(counters.countInsert(false);) // Count the insert.
+				return *link; // Return the node that holds the key.
+			}
+			if (mode != BalanceMode::None) { // If the tree is balanced, remember the link.
+				path[depth++] = link; // Add the link to the stack.
+			}
+			link = &(*link)->child(comparison > 0); // Move to the link of the subtree the key belongs to.
+		}
+		NodeType* newNode = create(); // Make a node that holds the key.
+		*link = newNode; // Link the new node into the tree.
+		++nodeCount; // Count the new node.
+		rebalancePath(path, depth); // Rebalance the nodes above the new node. Rotations move nodes but never replace them, so the new node stays valid.
+		if (mode == BalanceMode::RedBlack) { // If the tree is a red-black tree, the root must always be black.
+			root->red = false; // Color the root black.
+		}
+		added = true; // Report that a node was added.
+		BST_STATS(counters.countInsert(true);) // Count the insert.
+		return newNode; // Return the node that holds the key.
+	}
+
+	template <typename Order, typename Release>
+	void removeNode(const Order& order, const Release& release) { // This function removes the node whose key order finds, which must be in the tree, and gives it to release.
+		if (mode == BalanceMode::RedBlack) { // If the tree is a red-black tree, use the red-black removal algorithm.
+			if (!isRed(root->child(0)) && !isRed(root->child(1))) { // If both children of the root are black, the root must be colored red first.
+				root->red = true; // Color the root red so that a red link can be pushed down the search path.
+			}
+			removeRedBlack(order, release); // Remove the node.
+			if (root != nullptr) { // If the tree is not empty, the root must be black.
+				root->red = false; // Color the root black.
+			}
+		}
+		else { // Otherwise, use the plain removal algorithm, which also rebalances AVL trees.
+			removePlain(order, release); // Remove the node.
+		}
+		--nodeCount; // Count the removed node.
+	}
+
+	static bool isRed(const NodeType* node) { // This function checks if the given node is red (null nodes are black).
+		return node != nullptr && node->red; // Return true if the node exists and is red.
+	}
+
+	static int nodeHeight(const NodeType* node) { // This function returns the stored height of the given node (null nodes have height 0).
+		return node == nullptr ? 0 : node->height; // Return the stored height, or 0 for a null node.
+	}
+
+	static void updateHeight(NodeType* node) { // This function recomputes the stored height of the given node from its children.
+		node->height = static_cast<int16_t>(1 + max(nodeHeight(node->child(0)), nodeHeight(node->child(1)))); // The height is one more than the height of the taller child.
+	}
+
+private: // This section contains private members of the class.
+	template <typename Order, typename Release>
+	void removePlain(const Order& order, const Release& release) { // This function removes the node whose key order finds from an unbalanced or AVL tree without recursion.
+		NodeType** path[maxPathLength]; // Create a stack of the links on the search path, so they can be rebalanced from the bottom up. An unbalanced tree is never rebalanced, so its links are not stored.
+		int depth = 0; // Create a counter for the links on the stack.
+		NodeType** link = &root; // Start at the link to the root.
+		int comparison; // Create a variable to store the result of each comparison.
+		while ((comparison = order(*link)) != 0) { // Walk down until the link holds the key.
+			if (mode != BalanceMode::None) { // If the tree is balanced, remember the link.
+				path[depth++] = link; // Add the link to the stack.
+			}
+			link = &(*link)->child(comparison > 0); // Move to the link of the subtree the key is in.
+		}
+		NodeType* node = *link; // Get the node that holds the key.
+		if (node->child(0) == nullptr || node->child(1) == nullptr) { // If the node has at most one child, the child takes its place.
+			*link = node->child(node->child(0) == nullptr); // Link the only child, or null, in place of the node.
+			release(node); // Free the node.
+			rebalancePath(path, depth); // Rebalance the nodes above the removed node.
+			return; // The node is removed.
+		}
+		int nodeDepth = depth; // Remember where the link to the node is on the stack.
+		if (mode != BalanceMode::None) { // If the tree is balanced, remember the link to the node, whose right subtree gets shorter.
+			path[depth++] = link; // Add the link to the stack.
+		}
+		NodeType** successorLink = &node->child(1); // Start at the link to the right subtree.
+		while ((*successorLink)->child(0) != nullptr) { // Walk down to the node with the next larger key.
+			if (mode != BalanceMode::None) { // If the tree is balanced, remember the link.
+				path[depth++] = successorLink; // Add the link to the stack.
+			}
+			successorLink = &(*successorLink)->child(0); // Move to the left child.
+		}
+		NodeType* successor = *successorLink; // Get the successor.
+		*successorLink = successor->child(1); // Take the successor out of the right subtree.
+		replaceNode(link, successor, path, nodeDepth, depth, release); // Put the successor in place of the node, so no key or value has to be copied.
+		rebalancePath(path, depth); // Rebalance the nodes above the successor's old place.
+	}
+
+	template <typename Order, typename Release>
+	void removeRedBlack(const Order& order, const Release& release) { // This function removes the node whose key order finds from a red-black tree without recursion.
+		NodeType** path[maxPathLength]; // Create a stack of the links on the search path, so they can be rebalanced from the bottom up.
+		int depth = 0; // Create a counter for the links on the stack.
+		NodeType** link = &root; // Start at the link to the root.
+		while (true) { // Walk down until the node is removed.
+			NodeType* node = *link; // Get the current node.
+			if (order(node) < 0) { // If the key is less than the current node's key, remove the key from the left subtree.
+				if (!isRed(node->child(0)) && !isRed(node->child(0)->child(0))) { // If the left child is a 2-node, borrow a red link before descending.
+					node = *link = moveRedLeft(node); // Move a red link to the left.
+				}
+				path[depth++] = link; // Remember the link, so the node is rebalanced on the way back up.
+				link = &node->child(0); // Move to the left subtree.
+				continue; // Continue with the left child.
+			}
+			if (isRed(node->child(0))) { // If the left child is red, lean the red link to the right before descending.
+				node = *link = rotateRight(node); // Rotate the current node to the right.
+			}
+			if (order(node) == 0 && node->child(1) == nullptr) { // If the current node holds the key and is at the bottom of the tree, it can be deleted.
+				*link = nullptr; // Remove the node from the tree.
+				release(node); // Free the node.
+				break; // The node is removed.
+			}
+			if (!isRed(node->child(1)) && !isRed(node->child(1)->child(0))) { // If the right child is a 2-node, borrow a red link before descending.
+				node = *link = moveRedRight(node); // Move a red link to the right.
+			}
+			if (order(node) == 0) { // If the current node holds the key, replace it with its successor.
+				int nodeDepth = depth; // Remember where the link to the node is on the stack.
+				path[depth++] = link; // Remember the link, so the successor is rebalanced in its place.
+				NodeType** minimumLink = &node->child(1); // Start at the link to the right subtree.
+				while (true) { // Walk down to the successor, borrowing red links on the way.
+					NodeType* minimum = *minimumLink; // Get the current node of the right subtree.
+					if (minimum->child(0) == nullptr) { // If there is no left child, the current node is the successor. In a left-leaning red-black tree it has no right child either.
+						*minimumLink = nullptr; // Take the successor out of the right subtree.
+						replaceNode(link, minimum, path, nodeDepth, depth, release); // Put the successor in place of the node.
+						break; // The node is removed.
+					}
+					if (!isRed(minimum->child(0)) && !isRed(minimum->child(0)->child(0))) { // If the left child is a 2-node, borrow a red link before descending.
+						minimum = *minimumLink = moveRedLeft(minimum); // Move a red link to the left.
+					}
+					path[depth++] = minimumLink; // Remember the link, so the node is rebalanced on the way back up.
+					minimumLink = &minimum->child(0); // Move to the left subtree.
+				}
+				break; // The key is removed.
+			}
+			path[depth++] = link; // Remember the link, so the node is rebalanced on the way back up.
+			link = &node->child(1); // Otherwise, the key is in the right subtree.
+		}
+		rebalancePath(path, depth); // Rebalance the nodes above the removed node.
+	}
+
+	template <typename Release>
+	static void replaceNode(NodeType** link, NodeType* successor, NodeType** path[], int nodeDepth, int depth, const Release& release) { // This function puts the successor where the node on the link was, with the node's subtrees, and frees the node.
+		NodeType* node = *link; // Get the node that is removed.
+		successor->child(0) = node->child(0); // Take over the left subtree.
+		successor->child(1) = node->child(1); // Take over the right subtree, which no longer holds the successor.
+		successor->height = node->height; // Take over the height, which the rebalancing recomputes.
+		successor->red = node->red; // Take over the color of the link from the parent.
+		*link = successor; // Link the successor in place of the node.
+		if (depth > nodeDepth + 1) { // If the stack holds the link to the node's right subtree, it now belongs to the successor.
+			path[nodeDepth + 1] = &successor->child(1); // Point the link at the successor.
+		}
+		release(node); // Free the removed node.
+	}
+
+	void rebalancePath(NodeType** const* path, int depth) { // This function rebalances the nodes on the given links, from the deepest link up to the root.
+		while (depth > 0) { // Loop through the links from the bottom up.
+			--depth; // Move to the next link up.
+			*path[depth] = rebalance(*path[depth]); // Rebalance the node and link the new root of its subtree.
+		}
+	}
+
+	NodeType* rebalance(NodeType* node) { // This function restores the balance invariant of the selected mode at the given node.
+		if (mode == BalanceMode::AVL) { // If the tree is an AVL tree, fix any height difference larger than one.
+			updateHeight(node); // Recompute the height of the current node.
+			int balance = nodeHeight(node->child(0)) - nodeHeight(node->child(1)); // Calculate the balance factor of the current node.
+			if (balance > 1) { // If the left subtree is too tall, rotate to the right.
+				if (nodeHeight(node->child(0)->child(0)) < nodeHeight(node->child(0)->child(1))) { // If the left subtree leans right, rotate it to the left first.
+					node->child(0) = rotateLeft(node->child(0)); // Rotate the left child to the left.
+				}
+				return rotateRight(node); // Rotate the current node to the right.
+			}
+			if (balance < -1) { // If the right subtree is too tall, rotate to the left.
+				if (nodeHeight(node->child(1)->child(1)) < nodeHeight(node->child(1)->child(0))) { // If the right subtree leans left, rotate it to the right first.
+					node->child(1) = rotateRight(node->child(1)); // Rotate the right child to the right.
+				}
+				return rotateLeft(node); // Rotate the current node to the left.
+			}
+		}
+		else if (mode == BalanceMode::RedBlack) { // If the tree is a red-black tree, restore the left-leaning invariants.
+			if (isRed(node->child(1)) && !isRed(node->child(0))) { // If a red link leans right, rotate it to the left.
+				node = rotateLeft(node); // Rotate the current node to the left.
+			}
+			if (isRed(node->child(0)) && isRed(node->child(0)->child(0))) { // If there are two red links in a row, rotate to the right.
+				node = rotateRight(node); // Rotate the current node to the right.
+			}
+			if (isRed(node->child(0)) && isRed(node->child(1))) { // If both children are red, split the temporary 4-node.
+				flipColors(node); // Flip the colors of the current node and its children.
+			}
+		}
+		return node; // Return the root of the subtree.
+	}
+
+	NodeType* rotateLeft(NodeType* node) { // This function rotates the given node to the left and returns the new subtree root.
+		BST_STATS(counters.countRotation();) // Count the rotation.
+		NodeType* temp = node->child(1); // Store the right child, which becomes the new subtree root.
+		node->child(1) = temp->child(0); // Move the left subtree of the new root under the old root.
+		temp->child(0) = node; // Make the old root the left child of the new root.
+		temp->red = node->red; // The new root takes over the color of the old root.
+		node->red = true; // The old root is now connected by a red link.
+		updateHeight(node); // Recompute the height of the old root.
+		updateHeight(temp); // Recompute the height of the new root.
+		return temp; // Return the new subtree root.
+	}
+
+	NodeType* rotateRight(NodeType* node) { // This function rotates the given node to the right and returns the new subtree root.
+		BST_STATS(counters.countRotation();) // Count the rotation.
+		NodeType* temp = node->child(0); // Store the left child, which becomes the new subtree root.
+		node->child(0) = temp->child(1); // Move the right subtree of the new root under the old root.
+		temp->child(1) = node; // Make the old root the right child of the new root.
+		temp->red = node->red; // The new root takes over the color of the old root.
+		node->red = true; // The old root is now connected by a red link.
+		updateHeight(node); // Recompute the height of the old root.
+		updateHeight(temp); // Recompute the height of the new root.
+		return temp; // Return the new subtree root.
+	}
+
+	NodeType* moveRedLeft(NodeType* node) { // This function makes the left child or one of its children red before descending left in a red-black tree.
+		flipColors(node); // Combine the current node and its children into a temporary 4-node.
+		if (isRed(node->child(1)->child(0))) { // If the right sibling has a red child, borrow it instead.
+			node->child(1) = rotateRight(node->child(1)); // Rotate the right child to the right.
+			node = rotateLeft(node); // Rotate the current node to the left.
+			flipColors(node); // Split the temporary 4-node again.
+		}
+		return node; // Return the root of the subtree.
+	}
+
+	NodeType* moveRedRight(NodeType* node) { // This function makes the right child or one of its children red before descending right in a red-black tree.
+		flipColors(node); // Combine the current node and its children into a temporary 4-node.
+		if (isRed(node->child(0)->child(0))) { // If the left sibling has a red child, borrow it instead.
+			node = rotateRight(node); // Rotate the current node to the right.
+			flipColors(node); // Split the temporary 4-node again.
+		}
+		return node; // Return the root of the subtree.
+	}
+
+	static void flipColors(NodeType* node) { // This function flips the colors of the given node and its two children.
+		node->red = !node->red; // Flip the color of the current node.
+		node->child(0)->red = !node->child(0)->red; // Flip the color of the left child.
+		node->child(1)->red = !node->child(1)->red; // Flip the color of the right child.
+	}
+};
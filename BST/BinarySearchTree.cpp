@@ -6,139 +6,856 @@ structure.
 */
 
 #include "BinarySearchTree.h" // This is a header file that contains the implementation of a binary search tree.
+#include <queue> // This is a header file library that lets us work with first-in first-out queues.
+#include <algorithm> // This is a header file library that lets us use algorithms such as max.
+#include <cstring> // This is a header file library that lets us compare raw memory with memcmp.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+#include <fstream> // This is a header file library that lets us work with files.
+#include <iterator> // This is a header file library that lets us use iterators such as back_inserter.
+#include <atomic> // This is a header file library that lets threads report a mismatch to each other.
 
-BinarySearchTree::BinarySearchTree() : root(nullptr) {} // This is the default constructor for the binary search tree.
+static const size_t parallelGrain = 16384; // This number stores how many keys a task handles at least, so the cost of a task stays small next to its work.
 
-void BinarySearchTree::insert(string word) { // This function inserts a node with the given word into the binary search tree.
-	root = insertRecursive(root, word); // Call the recursive insert function to insert the node.
+template <typename Left, typename Right>
+static void forkJoin(TaskPool* tasks, size_t work, const Left& left, const Right& right) { // This function runs both functions on the task pool if there is one and the work is large enough, and one after the other otherwise.
+	if (tasks != nullptr && work >= parallelGrain) { // If the work is worth splitting, let another thread take the second function.
+		tasks->invoke(left, right); // Run both functions, possibly at the same time.
+	}
+	else { // Otherwise, run both functions here.
+		left(); // Run the first function.
+		right(); // Run the second function.
+	}
 }
 
-Node* BinarySearchTree::insertRecursive(Node* node, string word) { // This function inserts a node with the given word into the binary search tree.
-	if (node == nullptr) { // If the current node is null, create a new node with the given word.
-		return new Node{ word }; // Return the new node.
-    }
+template <template <typename> class Allocator>
+BasicBinarySearchTree<Allocator>::BasicBinarySearchTree() : BalancedTree<Node>(BalanceMode::None) {} // This is the default constructor for the binary search tree.
 
-	if (word < node->data) { // If the given word is less than the current node's data, insert the word into the left subtree.
-		node->left = insertRecursive(node->left, word); // Recursively insert the word into the left subtree.
-    }
-	else if (word > node->data) { // If the given word is greater than the current node's data, insert the word into the right subtree.
-		node->right = insertRecursive(node->right, word); // Recursively insert the word into the right subtree.
-    }
+template <template <typename> class Allocator>
+BasicBinarySearchTree<Allocator>::BasicBinarySearchTree(BalanceMode mode) : BalancedTree<Node>(mode) {} // This is a constructor that creates an empty binary search tree with the given balancing strategy.
 
-	return node; // Return the current node.
+template <template <typename> class Allocator>
+BasicBinarySearchTree<Allocator>::BasicBinarySearchTree(string_view word) : BalancedTree<Node>(BalanceMode::None) { // This is a constructor that initializes the binary search tree with a single node containing the given word.
+	insert(word); // Insert the word into the empty tree.
 }
 
-bool BinarySearchTree::remove(string word) { // This function removes a node with the given word from the binary search tree.
-	Node* result = removeRecursive(root, word); // Call the recursive remove function to remove the node.
-	if (result == nullptr) { // If the result is null, the node was not found.
+template <template <typename> class Allocator>
+BasicBinarySearchTree<Allocator>::BasicBinarySearchTree(const BasicBinarySearchTree& rhs) : BalancedTree<Node>(rhs.mode) { // This is the copy constructor for the binary search tree. The copy has the same shape, and subtrees are copied on the shared task pool.
+	cloneFrom(rhs, TaskPool::shared()); // Copy the nodes and keys of the other tree.
+}
+
+template <template <typename> class Allocator>
+BasicBinarySearchTree<Allocator>& BasicBinarySearchTree<Allocator>::operator=(const BasicBinarySearchTree& rhs) { // This is the copy assignment operator for the binary search tree. The copy has the same shape, and subtrees are copied on the shared task pool.
+	if (this != &rhs) { // Assigning a tree to itself changes nothing.
+		cloneFrom(rhs, TaskPool::shared()); // Copy the nodes and keys of the other tree, reusing the nodes of this one.
+	}
+	return *this; // Return the tree, so assignments can be chained.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::insert(string_view word) { // This function inserts a node with the given word into the binary search tree.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	bool added = false; // Create a flag to store whether the word was new.
+	insertNode([this, &key](const Node* node) { return compareKey(key, node); }, [this, &key]() { // Order the word against the nodes on the search path, and if it is new,
+		Node* newNode = nodes.allocate(); // take a new node from the allocator,
+		newNode->prefix = key.prefix; // store the prefix of the key in it,
+		newNode->offset = keyPool.append(key.text); // copy the key into the key pool and store where it starts,
+		newNode->length = static_cast<uint32_t>(key.text.size()); // and store the length of the key.
+		return newNode; // Return the new node.
+	}, added); // The flag is only needed by the core, which counts the insert.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::remove(string_view word) { // This function removes a node with the given word from the binary search tree.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	if (findNode(key) == nullptr) { // If the word is not in the tree, there is nothing to remove.
+		BST_STATS(counters.countRemove(false);) // Count the remove that found nothing.
 		return false; // Return false to indicate that the node was not removed.
-    }
-	root = result; // Update the root node.
+	}
+	BST_STATS(counters.countRemove(true);) // Count the remove.
+	removeNode([this, &key](const Node* node) { return compareKey(key, node); }, // Remove the node that holds the word, rebalancing in the tree's mode,
+		[this](Node* node) { nodes.deallocate(node); }); // and return it to the allocator.
+	keyPool.release(key.text.size()); // The characters of the removed key are no longer used.
+	if (keyPool.needsCompaction()) { // If the pool is mostly made of removed keys, rebuild it.
+		compactKeys(); // Rebuild the key pool.
+	}
 	return true; // Return true to indicate that the node was removed.
 }
 
-Node* BinarySearchTree::removeRecursive(Node* node, string word) { // This function removes a node with the given word from the binary search tree.
-	if (node == nullptr) { // If the current node is null, return null.
-		return nullptr; // Return null.
-    }
-
-	if (word < node->data) { // If the given word is less than the current node's data, remove the word from the left subtree.
-		node->left = removeRecursive(node->left, word); // Recursively remove the word from the left subtree.
-    }
-	else if (word > node->data) { // If the given word is greater than the current node's data, remove the word from the right subtree.
-		node->right = removeRecursive(node->right, word); // Recursively remove the word from the right subtree.
-    }
-	else { // If the given word is equal to the current node's data, remove the current node.
-		if (node->left == nullptr) { // If the left child is null, replace the current node with the right child.
-			Node* temp = node->right; // Store the right child in a temporary variable.
-			delete node; // Delete the current node.
-			return temp; // Return the right child.
-        }
-		else if (node->right == nullptr) { // If the right child is null, replace the current node with the left child.
-			Node* temp = node->left; // Store the left child in a temporary variable.
-			delete node; // Delete the current node.
-			return temp; // Return the left child.
-        }
-
-		Node* temp = findMinNode(node->right); // Find the node with the minimum value in the right subtree.
-		node->data = temp->data; // Replace the current node's data with the minimum value.
-		node->right = removeRecursive(node->right, temp->data); // Recursively remove the minimum value from the right subtree.
-    }
-	return node; // Return the current node.
-}
-
-Node* BinarySearchTree::findMinNode(Node* node) { // This function finds the node with the minimum value in the binary search tree.
-	while (node->left != nullptr) { // Traverse the left subtree until the left child is null.
-		node = node->left; // Move to the left child.
-    }
-	return node; // Return the node with the minimum value.
-}
-
-bool BinarySearchTree::exists(string word) const { // This function checks if a node with the given word exists in the binary search tree.
-	return findRecursive(root, word) != nullptr; // Call the recursive find function and return true if the node is found, false otherwise.
-}
-
-Node* BinarySearchTree::findRecursive(Node* node, string word) const { // This function finds a node with the given word in the binary search tree.
-	if (node == nullptr || node->data == word) { // If the current node is null or the data matches the given word, return the current node.
-		return node; // Return the current node.
-    }
-
-	if (word < node->data) { // If the given word is less than the current node's data, search the left subtree.
-		return findRecursive(node->left, word); // Recursively search the left subtree.
-    }
-	return findRecursive(node->right, word); // Otherwise, search the right subtree.
-}
-
-string BinarySearchTree::inorder() const { // This function returns the inorder traversal of the binary search tree as a string.
-	string result; // Create an empty string to store the traversal result.
-	inorderTraverseRecursive(root, result); // Call the recursive inorder traversal function to populate the result.
-	return result; // Return the traversal result.
+template <template <typename> class Allocator>
+int BasicBinarySearchTree<Allocator>::compareKey(const SearchKey& key, const Node* node) const { // This function compares the given key with the key of the node and returns a negative, zero or positive number.
+	if (key.prefix != node->prefix) { // If the first eight bytes differ, the prefixes alone decide the order.
+		return key.prefix < node->prefix ? -1 : 1; // Return the order of the prefixes.
+	}
+	size_t common = min(key.text.size(), static_cast<size_t>(node->length)); // Calculate the number of characters both keys have.
+	if (common > 8) { // If both keys are longer than the prefix, compare the rest of the characters in the key pool.
+		int result = memcmp(key.text.data() + 8, keyPool.data() + node->offset + 8, common - 8); // Compare the characters after the prefix.
+		if (result != 0) { // If the characters differ, they decide the order.
+			return result; // Return the order of the characters.
+		}
+	}
+	if (key.text.size() == node->length) { // If all shared characters are equal and the keys have the same length, the keys are equal.
+		return 0; // Return 0 to indicate that the keys are equal.
+	}
+	return key.text.size() < node->length ? -1 : 1; // Otherwise, the shorter key comes first.
 }
 
-void BinarySearchTree::inorderTraverseRecursive(Node* node, string& result) const { // This function traverses the binary search tree in inorder and stores the result in a string.
-	if (node != nullptr) { // If the current node is not null, traverse the left subtree, visit the current node, and traverse the right subtree.
-		inorderTraverseRecursive(node->left, result); // Recursively traverse the left subtree.
-		result += node->data + " "; // Append the current node's data to the result string.
-		inorderTraverseRecursive(node->right, result); // Recursively traverse the right subtree.
-    }
+template <template <typename> class Allocator>
+string_view BasicBinarySearchTree<Allocator>::keyOf(const Node* node) const { // This function returns the key of the given node.
+	return keyPool.view(node->offset, node->length); // Return a view of the key in the key pool.
 }
 
-string BinarySearchTree::preorder() const { // This function returns the preorder traversal of the binary search tree as a string.
-	string result; // Create an empty string to store the traversal result.
-	preorderTraverseRecursive(root, result); // Call the recursive preorder traversal function to populate the result.
-	return result; // Return the traversal result.
+template <template <typename> class Allocator>
+SearchKey BasicBinarySearchTree<Allocator>::searchKeyOf(const Node* node) const { // This function returns a search key for the key of the given node.
+	return SearchKey{ keyOf(node), node->prefix }; // Return the key together with its cached prefix.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::compactKeys() { // This function rebuilds the key pool so it only holds the keys that are still in the tree.
+	BST_STATS(counters.countCompaction();) // Count the rebuild of the key pool.
+	KeyPool compacted; // Create a new, empty key pool.
+	vector<Node*> stack; // Create a stack of nodes that still have to be visited.
+	if (root != nullptr) { // If the tree is not empty, start at the root.
+		stack.push_back(root); // Add the root to the stack.
+	}
+	while (!stack.empty()) { // Visit every node without recursion.
+		Node* node = stack.back(); // Take the next node from the stack.
+		stack.pop_back(); // Remove the node from the stack.
+		node->offset = compacted.append(keyOf(node)); // Copy the key into the new pool and remember where it starts.
+		if (node->left != nullptr) { // If the node has a left child, visit it later.
+			stack.push_back(node->left); // Add the left child to the stack.
+		}
+		if (node->right != nullptr) { // If the node has a right child, visit it later.
+			stack.push_back(node->right); // Add the right child to the stack.
+		}
+	}
+	keyPool = move(compacted); // Replace the old pool with the new one.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::exists(string_view word) const { // This function checks if a node with the given word exists in the binary search tree.
+	bool found = findNode(KeyPool::makeSearchKey(word)) != nullptr; // Call the find function to check if the node is there.
+	BST_STATS(counters.countLookup(found);) // Count the lookup.
+	return found; // Return true if the node is found, false otherwise.
+}
+
+template <template <typename> class Allocator>
+Node* BasicBinarySearchTree<Allocator>::findNode(const SearchKey& key) const { // This function finds the node with the given key in the binary search tree, or returns null.
+	Node* node = root; // Start at the root.
+	BST_STATS(size_t comparisons = 0;) // Create a counter for the comparisons of the search.
+	while (node != nullptr) { // Walk down until the key is found or the subtree is empty.
+		int comparison = compareKey(key, node); // Compare the given key with the current node's key.
+		BST_STATS(++comparisons;) // Count the comparison.
+		if (comparison == 0) { // If the key matches the current node's key, return the current node.
+			BST_STATS(counters.countSearch(comparisons);) // Record the length of the search.
+			return node; // Return the current node.
+		}
+		node = comparison < 0 ? node->left : node->right; // Move to the subtree the key belongs to.
+	}
+	BST_STATS(counters.countSearch(comparisons);) // Record the length of the search.
+	return nullptr; // Return null to indicate that the key is not in the tree.
+}
+
+template <template <typename> class Allocator>
+typename BasicBinarySearchTree<Allocator>::const_iterator BasicBinarySearchTree<Allocator>::begin() const { // This function returns an iterator to the smallest key.
+	const_iterator it(this); // Create an iterator at the end.
+	it.descendLeft(root); // Walk down to the smallest key.
+	return it; // Return the iterator.
+}
+
+template <template <typename> class Allocator>
+typename BasicBinarySearchTree<Allocator>::const_iterator BasicBinarySearchTree<Allocator>::end() const { // This function returns an iterator past the largest key.
+	return const_iterator(this); // An iterator with an empty path is at the end.
+}
+
+template <template <typename> class Allocator>
+typename BasicBinarySearchTree<Allocator>::const_iterator BasicBinarySearchTree<Allocator>::find(string_view word) const { // This function returns an iterator to the given word, or end if the word is not in the tree.
+	const_iterator it = lower_bound(word); // Find the smallest key that is not less than the word.
+	if (it.path.empty() || compareKey(KeyPool::makeSearchKey(word), it.path.back()) != 0) { // If that key is not the word, the word is not in the tree.
+		return end(); // Return the end iterator.
+	}
+	return it; // Return the iterator to the word.
+}
+
+template <template <typename> class Allocator>
+typename BasicBinarySearchTree<Allocator>::const_iterator BasicBinarySearchTree<Allocator>::lower_bound(string_view word) const { // This function returns an iterator to the smallest key that is not less than the word.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	const_iterator it(this); // Create an iterator at the end.
+	size_t keep = 0; // Create a variable to store the length of the path to the best node so far.
+	for (const Node* node = root; node != nullptr; ) { // Walk down the search path of the word.
+		it.path.push_back(node); // Add the node to the path.
+		if (compareKey(key, node) <= 0) { // If the node is not less than the word, it is the best candidate so far, and smaller candidates are on the left.
+			keep = it.path.size(); // Remember the path to the node.
+			node = node->left; // Move to the left child.
+		}
+		else { // Otherwise, the candidates are on the right.
+			node = node->right; // Move to the right child.
+		}
+	}
+	it.path.resize(keep); // Cut the path back to the best node, or to nothing if no key is large enough.
+	return it; // Return the iterator.
+}
+
+template <template <typename> class Allocator>
+typename BasicBinarySearchTree<Allocator>::const_iterator BasicBinarySearchTree<Allocator>::upper_bound(string_view word) const { // This function returns an iterator to the smallest key that is greater than the word.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	const_iterator it(this); // Create an iterator at the end.
+	size_t keep = 0; // Create a variable to store the length of the path to the best node so far.
+	for (const Node* node = root; node != nullptr; ) { // Walk down the search path of the word.
+		it.path.push_back(node); // Add the node to the path.
+		if (compareKey(key, node) < 0) { // If the node is greater than the word, it is the best candidate so far, and smaller candidates are on the left.
+			keep = it.path.size(); // Remember the path to the node.
+			node = node->left; // Move to the left child.
+		}
+		else { // Otherwise, the candidates are on the right.
+			node = node->right; // Move to the right child.
+		}
+	}
+	it.path.resize(keep); // Cut the path back to the best node, or to nothing if no key is large enough.
+	return it; // Return the iterator.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::write(ostream& out, TraversalOrder order, char separator) const { // This function writes the keys to the stream in the given order, each followed by the separator, without building a string.
+	forEach(order, [&out, separator](string_view key) { // Visit the keys in the given order.
+		out.write(key.data(), static_cast<streamsize>(key.size())); // Write the characters of the key.
+		out.put(separator); // Write the separator.
+	});
+}
+
+template <template <typename> class Allocator>
+string BasicBinarySearchTree<Allocator>::inorder() const { // This function returns the inorder traversal of the binary search tree as a string.
+	return traversalString(TraversalOrder::Inorder); // Collect the keys in inorder.
+}
+
+template <template <typename> class Allocator>
+string BasicBinarySearchTree<Allocator>::preorder() const { // This function returns the preorder traversal of the binary search tree as a string.
+	return traversalString(TraversalOrder::Preorder); // Collect the keys in preorder.
 }
 
-void BinarySearchTree::preorderTraverseRecursive(Node* node, string& result) const { // This function traverses the binary search tree in preorder and stores the result in a string.
-	if (node != nullptr) { // If the current node is not null, visit the current node, traverse the left subtree, and traverse the right subtree.
-		result += node->data + " "; // Append the current node's data to the result string.
-		preorderTraverseRecursive(node->left, result); // Recursively traverse the left subtree.
-		preorderTraverseRecursive(node->right, result); // Recursively traverse the right subtree.
-    }
+template <template <typename> class Allocator>
+string BasicBinarySearchTree<Allocator>::postorder() const { // This function returns the postorder traversal of the binary search tree as a string.
+	return traversalString(TraversalOrder::Postorder); // Collect the keys in postorder.
 }
 
-string BinarySearchTree::postorder() const { // This function returns the postorder traversal of the binary search tree as a string.
+template <template <typename> class Allocator>
+string BasicBinarySearchTree<Allocator>::traversalString(TraversalOrder order) const { // This function returns the keys in the given order as one string, separated by spaces.
 	string result; // Create an empty string to store the traversal result.
-	postorderTraverseRecursive(root, result); // Call the recursive postorder traversal function to populate the result.
+	result.reserve(keyPool.size() + nodeCount); // Make room for every key and separator, so the string never has to grow. The key pool holds at least the live keys.
+	forEach(order, [&result](string_view key) { // Visit the keys in the given order.
+		result += key; // Append the key to the result string.
+		result += ' '; // Separate the key from the next one.
+	});
 	return result; // Return the traversal result.
 }
 
-void BinarySearchTree::postorderTraverseRecursive(Node* node, string& result) const { // This function traverses the binary search tree in postorder and stores the result in a string.
-	if (node != nullptr) { // If the current node is not null, traverse the left subtree, traverse the right subtree, and visit the current node.
-		postorderTraverseRecursive(node->left, result); // Recursively traverse the left subtree.
-		postorderTraverseRecursive(node->right, result); // Recursively traverse the right subtree.
-		result += node->data + " "; // Append the current node's data to the result string.
-    }
+template <template <typename> class Allocator>
+int BasicBinarySearchTree<Allocator>::height() const { // This function returns the number of nodes on the longest path from the root to a leaf.
+	int levels = 0; // Create a counter for the number of levels in the tree.
+	queue<Node*> current; // Create a queue that holds the nodes of the current level.
+	if (root != nullptr) { // If the tree is not empty, start at the root.
+		current.push(root); // Add the root to the queue.
+	}
+	while (!current.empty()) { // Visit the tree one level at a time, so deep unbalanced trees do not overflow the stack.
+		size_t count = current.size(); // Store the number of nodes on the current level.
+		for (size_t i = 0; i < count; ++i) { // Loop through the nodes on the current level.
+			Node* node = current.front(); // Take the next node from the queue.
+			current.pop(); // Remove the node from the queue.
+			if (node->left != nullptr) { // If the node has a left child, it is on the next level.
+				current.push(node->left); // Add the left child to the queue.
+			}
+			if (node->right != nullptr) { // If the node has a right child, it is on the next level.
+				current.push(node->right); // Add the right child to the queue.
+			}
+		}
+		++levels; // Count the level that was just visited.
+	}
+	return levels; // Return the number of levels.
+}
+
+template <template <typename> class Allocator>
+BalanceMode BasicBinarySearchTree<Allocator>::balanceMode() const { // This function returns the balancing strategy used by the binary search tree.
+	return mode; // Return the balancing strategy.
+}
+
+#ifdef BST_ENABLE_STATS
+template <template <typename> class Allocator>
+TreeStatistics BasicBinarySearchTree<Allocator>::statistics() const { // This function returns a snapshot of the operation counters, the comparison histogram and the memory of the tree. It does not walk the tree.
+	TreeStatistics result; // Create the snapshot.
+	counters.copyTo(result); // Copy the counters.
+	result.size = nodeCount; // Store the number of keys.
+	result.nodeBytes = nodeCount * sizeof(Node); // Store the memory of the nodes in the tree.
+	if constexpr (Allocator<Node>::releasesAll) { // Arenas and pools hold slabs, which also contain free slots.
+		result.nodeBytesReserved = nodes.bytesReserved(); // Store the memory of the slabs.
+	}
+	else { // Allocators that allocate every node on its own hold exactly the nodes in the tree.
+		result.nodeBytesReserved = result.nodeBytes; // Store the memory of the nodes, without the overhead of the heap.
+	}
+	result.keyBytes = keyPool.size(); // Store the number of characters in the key pool.
+	result.keyBytesReleased = keyPool.releasedSize(); // Store the number of characters of removed keys.
+	result.keyBytesReserved = keyPool.capacity(); // Store the memory of the key pool.
+	return result; // Return the snapshot.
+}
+
+template <template <typename> class Allocator>
+TreeShape BasicBinarySearchTree<Allocator>::shape() const { // This function walks the tree and returns its height, average depth and largest imbalance.
+	return measureShape(root, nodeCount, [](const Node* node) { return pair<const Node*, const Node*>(node->left, node->right); }); // Measure the tree.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::resetStatistics() { // This function sets the operation counters and the comparison histogram back to zero.
+	counters.reset(); // Clear the counters.
+}
+#endif
+
+template <template <typename> class Allocator>
+vector<string_view> BasicBinarySearchTree<Allocator>::inorderKeys(TaskPool* tasks) const { // This function returns the keys of the binary search tree in sorted order, collecting subtrees on several threads if a task pool is given.
+	vector<string_view> keys; // Create a vector to store the keys.
+	if (tasks == nullptr || tasks->threadCount() == 1 || nodeCount < parallelGrain) { // If there is nobody to share the work with, or too little work, walk the tree here.
+		keys.reserve(nodeCount); // Make room for all keys.
+		forEach([&keys](string_view key) { // Visit the keys in sorted order.
+			keys.push_back(key); // Add the key to the vector.
+		});
+		return keys; // Return the keys.
+	}
+	vector<pair<const Node*, bool>> pieces; // Create a vector to store the pieces of the tree, in sorted order.
+	collectPieces(root, parallelDepth(*tasks), pieces); // Split the top levels of the tree into pieces.
+	vector<vector<string_view>> parts(pieces.size()); // Create a vector to store the keys of every piece. Subtree sizes are unknown, so every piece collects its own keys first.
+	tasks->parallelFor(0, pieces.size(), 1, [&](size_t i) { // Collect the keys of every piece on its own.
+		if (pieces[i].second) { // If the piece is a whole subtree, walk it.
+			auto visit = [&parts, i](string_view key) { parts[i].push_back(key); }; // Create a visitor that adds the key to the part.
+			forEachInorder(pieces[i].first, visit); // Visit the keys of the subtree in sorted order.
+		}
+		else { // Otherwise, the piece is a single node.
+			parts[i].push_back(keyOf(pieces[i].first)); // Add the key of the node.
+		}
+	});
+	concatenate(parts, keys, *tasks); // Put the pieces together.
+	return keys; // Return the keys.
+}
+
+template <template <typename> class Allocator>
+size_t BasicBinarySearchTree<Allocator>::size() const { // This function returns the number of words in the binary search tree.
+	return nodeCount; // Return the number of nodes.
+}
+
+template <template <typename> class Allocator>
+FrozenBinarySearchTree BasicBinarySearchTree<Allocator>::freeze() const { // This function builds a read-only snapshot of the binary search tree that answers exists faster.
+	return FrozenBinarySearchTree(inorderKeys()); // Build the snapshot from the keys in sorted order.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::sortUnique(vector<string_view>& keys) { // This function sorts the keys and removes duplicates, skipping the sort if the keys are already sorted.
+	if (!is_sorted(keys.begin(), keys.end())) { // If the keys are not sorted yet, sort them. Sorted files only pay for this linear check.
+		sort(keys.begin(), keys.end()); // Sort the keys.
+	}
+	keys.erase(unique(keys.begin(), keys.end()), keys.end()); // Remove duplicate keys, which are next to each other after sorting.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::loadSorted(vector<string_view>& keys) { // This function replaces the contents of the tree with the given keys.
+	BST_STATS(size_t requested = keys.size();) // Remember the number of keys, so duplicates are counted as inserts too.
+	sortUnique(keys); // Sort the keys and remove duplicates.
+	rebuild(keys); // Build a balanced tree from the sorted keys.
+	BST_STATS(counters.countInserts(requested, keys.size());) // Count every key as an insert, and every unique key as a new one, because the tree was replaced.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::mergeSorted(vector<string_view>& keys) { // This function adds the given keys to the tree, either one at a time or by merging and rebuilding.
+	BST_STATS(size_t requested = keys.size();) // Remember the number of keys, so duplicates are counted as inserts too.
+	sortUnique(keys); // Sort the keys and remove duplicates.
+	BST_STATS(counters.countInserts(requested - keys.size(), 0);) // Count the duplicates in the batch as inserts that added nothing. The other keys are counted below.
+	size_t depth = 1; // Create a variable to store the depth of a balanced tree with the current number of nodes.
+	while ((size_t(1) << depth) <= nodeCount) { // Loop until the depth is large enough.
+		++depth; // Increase the depth.
+	}
+	if (keys.size() * depth < 2 * (nodeCount + keys.size())) { // If the batch is small compared to the tree, inserting the keys one at a time (in sorted order, so the search paths stay in the cache) is cheaper than a rebuild.
+		for (string_view key : keys) { // Loop through the keys.
+			insert(key); // Insert the key.
+		}
+		return; // Return without rebuilding.
+	}
+	vector<string_view> existing = inorderKeys(); // Get the keys that are already in the tree, in sorted order.
+	vector<string_view> merged; // Create a vector to store the union of both sorted lists.
+	merged.reserve(existing.size() + keys.size()); // Make room for all keys.
+	set_union(existing.begin(), existing.end(), keys.begin(), keys.end(), back_inserter(merged)); // Merge the two sorted lists in linear time, keeping every key once.
+	rebuild(merged); // Build a balanced tree from the merged keys.
+	BST_STATS(counters.countInserts(keys.size(), merged.size() - existing.size());) // Count the keys of the batch, and the ones that were not in the tree yet.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::rebuild(const vector<string_view>& sortedKeys, TaskPool* tasks) { // This function replaces the contents of the tree with a perfectly balanced tree of the given sorted, unique keys, filling and linking the nodes on several threads if a task pool is given.
+	BST_STATS(counters.countRebuild();) // Count the rebuild.
+	size_t count = sortedKeys.size(); // Get the number of keys.
+	vector<uint64_t> offsets(count + 1); // Create a vector to store where each key starts in the new pool, so every key can be copied independently.
+	for (size_t i = 0; i < count; ++i) { // Loop through the keys. The keys are stored in sorted order, so sorted walks read the pool from front to back.
+		offsets[i + 1] = offsets[i] + sortedKeys[i].size(); // The next key starts after this one.
+	}
+	KeyPool pool; // Create a new key pool. The keys may still point into the old one, so it is replaced only at the end.
+	char* characters = pool.extend(offsets[count]); // Make room for all characters at once, so threads can copy keys into their own places.
+	vector<Node*> slots = takeNodes(count); // Take a node for every key, in sorted order. The allocators are not thread-safe, so all nodes are taken here.
+
+	auto fill = [&](size_t i) { // Create a function that copies one key into its node and into the pool.
+		Node* node = slots[i]; // Get the node of the key.
+		string_view key = sortedKeys[i]; // Get the key.
+		memcpy(characters + offsets[i], key.data(), key.size()); // Copy the characters of the key into the new pool.
+		node->prefix = KeyPool::prefixOf(key); // Store the prefix of the key.
+		node->offset = offsets[i]; // Store where the key starts.
+		node->length = static_cast<uint32_t>(key.size()); // Store the length of the key.
+		node->height = 1; // Reset the height of the node.
+		node->red = true; // Reset the color of the node.
+	};
+	if (tasks != nullptr) { // If a task pool is given, fill the nodes on several threads.
+		tasks->parallelFor(0, count, parallelGrain, fill); // Fill the nodes in ranges of keys.
+	}
+	else { // Otherwise, fill them here.
+		for (size_t i = 0; i < count; ++i) { // Loop through the keys.
+			fill(i); // Fill the node.
+		}
+	}
+
+	if (mode == BalanceMode::RedBlack && count > 0) { // If the tree is a red-black tree, build it with valid colors.
+		int blackHeight = 0; // Create a variable to store the number of black nodes on every path.
+		while ((size_t(2) << blackHeight) <= count + 1) { // Use the largest black height whose smallest tree is not bigger than the number of keys.
+			++blackHeight; // Increase the black height.
+		}
+		root = buildRedBlack(slots.data(), 0, count, blackHeight, tasks); // Link the red-black tree.
+	}
+	else { // Otherwise, build a perfectly balanced tree, which is also a valid AVL tree.
+		root = buildBalanced(slots.data(), 0, count, tasks); // Link the balanced tree.
+	}
+	keyPool = move(pool); // Replace the old key pool with the new one.
+	nodeCount = count; // Store the new number of nodes.
+}
+
+template <template <typename> class Allocator>
+vector<Node*> BasicBinarySearchTree<Allocator>::takeNodes(size_t count) { // This function returns the given number of nodes, reusing the nodes of the tree before taking new ones from the allocator. The tree's links are left dangling.
+	vector<Node*> slots; // Create a vector to store the nodes.
+	slots.reserve(max(count, nodeCount)); // Make room for all new and old nodes.
+	if (root != nullptr) { // If the tree is not empty, collect its nodes, so they can be reused.
+		slots.push_back(root); // Start with the root.
+	}
+	for (size_t i = 0; i < slots.size(); ++i) { // Visit every old node without recursion, using the vector itself as the queue.
+		if (slots[i]->left != nullptr) { // If the node has a left child, collect it.
+			slots.push_back(slots[i]->left); // Add the left child.
+		}
+		if (slots[i]->right != nullptr) { // If the node has a right child, collect it.
+			slots.push_back(slots[i]->right); // Add the right child.
+		}
+	}
+	for (size_t i = count; i < slots.size(); ++i) { // Loop through the old nodes that are not needed.
+		nodes.deallocate(slots[i]); // Return the node to the allocator.
+	}
+	slots.resize(min(slots.size(), count)); // Keep only the old nodes that are reused.
+	while (slots.size() < count) { // Take the remaining nodes from the allocator.
+		slots.push_back(nodes.allocate()); // Allocate a node.
+	}
+	return slots; // Return the nodes.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::cloneFrom(const BasicBinarySearchTree& other, TaskPool& tasks) { // This function replaces the contents of the tree with a copy of the other tree in the same shape, copying its subtrees on several threads.
+	BST_STATS(counters.countRebuild();) // Count the copy as a rebuild, like a copy made by assign.
+	vector<Node*> slots = takeNodes(other.nodeCount); // Take a node for every node of the other tree. The allocators are not thread-safe, so all nodes are taken here.
+	int depth = other.nodeCount >= parallelGrain ? parallelDepth(tasks) : 0; // Split the top levels into pieces if the tree is large enough to share the work.
+	vector<pair<const Node*, bool>> pieces; // Create a vector to store the pieces of the other tree, in sorted order.
+	collectPieces(other.root, depth, pieces); // Split the top levels of the other tree into single nodes and whole subtrees.
+	vector<size_t> starts(pieces.size() + 1, 0); // Create a vector to store where the nodes of each piece start in the slots.
+	tasks.parallelFor(0, pieces.size(), 1, [&](size_t i) { // Count the nodes of every piece on its own.
+		starts[i + 1] = pieces[i].second ? subtreeSize(pieces[i].first) : 1; // A whole subtree needs a node for each of its nodes, and a single node needs one.
+	});
+	for (size_t i = 0; i < pieces.size(); ++i) { // Loop through the pieces.
+		starts[i + 1] += starts[i]; // The nodes of the next piece start after the nodes of this one.
+	}
+	vector<Node*> copies(pieces.size()); // Create a vector to store the copy of every piece.
+	tasks.parallelFor(0, pieces.size(), 1, [&](size_t i) { // Copy every piece on its own.
+		if (pieces[i].second) { // If the piece is a whole subtree, copy it with its links.
+			copies[i] = cloneSubtree(pieces[i].first, slots.data() + starts[i]); // Copy the subtree into its nodes.
+		}
+		else { // Otherwise, the piece is a single node, which is linked below.
+			copies[i] = slots[starts[i]]; // Get the node of the copy.
+			copyNode(copies[i], pieces[i].first); // Copy the node.
+		}
+	});
+	size_t next = 0; // Create an index for the next piece to link.
+	root = linkPieces(other.root, depth, copies.data(), next); // Link the copies of the top levels the way the other tree links them.
+	keyPool = other.keyPool; // Copy the key pool, so the copied nodes find their keys at the same offsets.
+	mode = other.mode; // Use the balancing strategy of the other tree.
+	nodeCount = other.nodeCount; // Store the new number of nodes.
+}
+
+template <template <typename> class Allocator>
+Node* BasicBinarySearchTree<Allocator>::cloneSubtree(const Node* source, Node* const* slots) { // This function copies the subtree into the given nodes in preorder, keeping its shape, without recursion.
+	size_t used = 0; // Create a counter for the nodes used so far.
+	Node* copyRoot = slots[used++]; // Take the node for the root of the subtree.
+	copyNode(copyRoot, source); // Copy the root.
+	vector<pair<const Node*, Node*>> stack = { { source, copyRoot } }; // Create a stack of copied nodes whose children still have to be copied.
+	while (!stack.empty()) { // Loop until every node has been copied.
+		auto [original, copy] = stack.back(); // Take the next pair of nodes.
+		stack.pop_back(); // Remove the pair from the stack.
+		if (original->left != nullptr) { // If the node has a left child, copy it.
+			copy->left = slots[used++]; // Take the node for the left child and link it.
+			copyNode(copy->left, original->left); // Copy the left child.
+			stack.push_back({ original->left, copy->left }); // Copy its children later.
+		}
+		if (original->right != nullptr) { // If the node has a right child, copy it.
+			copy->right = slots[used++]; // Take the node for the right child and link it.
+			copyNode(copy->right, original->right); // Copy the right child.
+			stack.push_back({ original->right, copy->right }); // Copy its children later.
+		}
+	}
+	return copyRoot; // Return the root of the copy.
+}
+
+template <template <typename> class Allocator>
+Node* BasicBinarySearchTree<Allocator>::linkPieces(const Node* node, int depth, Node* const* copies, size_t& next) { // This function links the copies of the pieces collectPieces made of the subtree the way the pieces were linked.
+	if (node == nullptr) { // An empty subtree has no piece.
+		return nullptr; // Return null.
+	}
+	if (depth == 0) { // Below the split levels, the whole subtree is one piece, which is already linked.
+		return copies[next++]; // Return the copy of the subtree.
+	}
+	Node* left = linkPieces(node->left, depth - 1, copies, next); // Link the left subtree first, because the pieces are in sorted order.
+	Node* copy = copies[next++]; // Get the copy of the node.
+	copy->left = left; // Link the left subtree.
+	copy->right = linkPieces(node->right, depth - 1, copies, next); // Link the right subtree.
+	return copy; // Return the copy of the subtree.
+}
+
+template <template <typename> class Allocator>
+size_t BasicBinarySearchTree<Allocator>::subtreeSize(const Node* node) { // This function counts the nodes of the subtree without recursion.
+	size_t count = 0; // Create a counter for the nodes.
+	vector<const Node*> stack; // Create a stack of nodes that still have to be counted.
+	if (node != nullptr) { // If the subtree is not empty, start at its root.
+		stack.push_back(node); // Add the root to the stack.
+	}
+	while (!stack.empty()) { // Loop until every node has been counted.
+		const Node* current = stack.back(); // Take the next node.
+		stack.pop_back(); // Remove the node from the stack.
+		++count; // Count the node.
+		if (current->left != nullptr) { // If the node has a left child, count it later.
+			stack.push_back(current->left); // Add the left child to the stack.
+		}
+		if (current->right != nullptr) { // If the node has a right child, count it later.
+			stack.push_back(current->right); // Add the right child to the stack.
+		}
+	}
+	return count; // Return the number of nodes.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::copyNode(Node* target, const Node* source) { // This function copies the key, height and color of the source node into the target node, and clears its links.
+	target->prefix = source->prefix; // Copy the prefix of the key.
+	target->offset = source->offset; // Copy where the key starts in the key pool.
+	target->length = source->length; // Copy the length of the key.
+	target->height = source->height; // Copy the height.
+	target->red = source->red; // Copy the color.
+	target->left = nullptr; // Clear the left link, which a reused node may still hold.
+	target->right = nullptr; // Clear the right link.
+}
+
+template <template <typename> class Allocator>
+Node* BasicBinarySearchTree<Allocator>::buildBalanced(Node* const* slots, size_t first, size_t last, TaskPool* tasks) { // This function links the nodes in [first, last), which hold the keys in sorted order, into a balanced subtree.
+	if (first >= last) { // If the range is empty, the subtree is empty.
+		return nullptr; // Return null.
+	}
+	size_t middle = first + (last - first) / 2; // The middle key becomes the root, so both subtrees differ in size by at most one.
+	Node* node = slots[middle]; // Get the root of the subtree.
+	forkJoin(tasks, last - first, [&]() { node->left = buildBalanced(slots, first, middle, tasks); }, // Build the left subtree from the smaller keys,
+		[&]() { node->right = buildBalanced(slots, middle + 1, last, tasks); }); // and the right subtree from the larger keys.
+	updateHeight(node); // Store the height of the subtree for AVL mode.
+	node->red = false; // Mark the node black, which is harmless outside red-black mode.
+	return node; // Return the root of the subtree.
+}
+
+template <template <typename> class Allocator>
+Node* BasicBinarySearchTree<Allocator>::buildRedBlack(Node* const* slots, size_t first, size_t last, int blackHeight, TaskPool* tasks) { // This function links the nodes in [first, last), which hold the keys in sorted order, into a left-leaning red-black subtree with the given black height.
+	if (first >= last) { // If the range is empty, the subtree is empty. The black height is 0 here by construction.
+		return nullptr; // Return null.
+	}
+	// A left-leaning red-black tree is a 2-3 tree in disguise: a black node alone is a 2-node, and a black node with a red left child is a 3-node.
+	// A 2-3 subtree with black height h holds between 2^h - 1 and 3^h - 1 keys, so each key range is split into two or three child ranges that fit.
+	size_t count = last - first; // Calculate the number of keys in the range.
+	uint64_t maxChild = 1; // Create a variable to store the largest number of keys a child subtree can hold.
+	for (int i = 1; i < blackHeight; ++i) { // Multiply by three once for every level below this one.
+		maxChild *= 3; // Each level can triple the number of keys.
+	}
+	maxChild -= 1; // A subtree with black height h holds at most 3^h - 1 keys.
+
+	if (count - 1 <= 2 * maxChild) { // If the keys fit under a 2-node, split them into two halves.
+		size_t middle = first + (count - 1) / 2; // The middle key becomes the black node.
+		Node* node = slots[middle]; // Get the black node.
+		node->red = false; // Color the node black.
+		forkJoin(tasks, count, [&]() { node->left = buildRedBlack(slots, first, middle, blackHeight - 1, tasks); }, // Build the left subtree,
+			[&]() { node->right = buildRedBlack(slots, middle + 1, last, blackHeight - 1, tasks); }); // and the right subtree.
+		return node; // Return the root of the subtree.
+	}
+
+	size_t firstCount = (count - 2) / 3; // Otherwise, use a 3-node and split the remaining keys into three nearly equal parts.
+	size_t secondCount = (count - 2 - firstCount) / 2; // Calculate the size of the middle part.
+	size_t smallKey = first + firstCount; // The key after the first part goes into the red node.
+	size_t largeKey = smallKey + 1 + secondCount; // The key after the middle part goes into the black node.
+	Node* node = slots[largeKey]; // Get the black node.
+	node->red = false; // Color the node black.
+	Node* redChild = slots[smallKey]; // Get the red node, which leans left.
+	redChild->red = true; // Color the node red.
+	forkJoin(tasks, count, [&]() { // Build the first and middle parts,
+		redChild->left = buildRedBlack(slots, first, smallKey, blackHeight - 1, tasks); // starting with the first part,
+		redChild->right = buildRedBlack(slots, smallKey + 1, largeKey, blackHeight - 1, tasks); // then the middle part,
+	}, [&]() { node->right = buildRedBlack(slots, largeKey + 1, last, blackHeight - 1, tasks); }); // and the last part.
+	node->left = redChild; // Attach the red node on the left.
+	return node; // Return the root of the subtree.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::collectPieces(const Node* node, int depth, vector<pair<const Node*, bool>>& pieces) { // This function splits the subtree into the nodes above the given depth and the whole subtrees below it, in sorted order.
+	if (node == nullptr) { // If the subtree is empty, there is nothing to collect.
+		return; // Return without adding a piece.
+	}
+	if (depth == 0) { // If the split levels are used up, the subtree stays in one piece.
+		pieces.emplace_back(node, true); // Add the whole subtree.
+		return; // Return after adding the piece.
+	}
+	collectPieces(node->left, depth - 1, pieces); // Collect the pieces of the left subtree first, so the pieces stay in sorted order.
+	pieces.emplace_back(node, false); // Add the node on its own.
+	collectPieces(node->right, depth - 1, pieces); // Collect the pieces of the right subtree.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::concatenate(vector<vector<string_view>>& parts, vector<string_view>& keys, TaskPool& tasks) { // This function copies the parts one after another into the keys, on several threads.
+	vector<size_t> starts(parts.size() + 1, 0); // Create a vector to store where each part starts.
+	for (size_t i = 0; i < parts.size(); ++i) { // Loop through the parts.
+		starts[i + 1] = starts[i] + parts[i].size(); // The next part starts after this one.
+	}
+	keys.resize(starts.back()); // Make room for all keys.
+	tasks.parallelFor(0, parts.size(), 1, [&](size_t i) { // Copy every part on its own.
+		copy(parts[i].begin(), parts[i].end(), keys.begin() + starts[i]); // Copy the part to its place.
+		vector<string_view>().swap(parts[i]); // Free the part, so the memory is returned while the other parts are copied.
+	});
+}
+
+template <template <typename> class Allocator>
+int BasicBinarySearchTree<Allocator>::parallelDepth(const TaskPool& tasks) { // This function returns how many levels of the tree are split into separate tasks, so every thread gets several subtrees.
+	if (tasks.threadCount() == 1) { // If the pool has a single thread, splitting only costs time.
+		return 0; // Do not split.
+	}
+	int depth = 0; // Create a variable to store the number of levels.
+	while ((size_t(1) << depth) < size_t(8) * tasks.threadCount()) { // Split until there are about eight subtrees per thread, so a thread that finishes early can steal more.
+		++depth; // Split one more level.
+	}
+	return depth; // Return the number of levels.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::combineSorted(const vector<string_view>& first, const vector<string_view>& second, SetOperation operation, vector<string_view>& keys, TaskPool& tasks) { // This function applies the set operation to two sorted lists of keys, splitting them into ranges that are combined on several threads.
+	const vector<string_view>& longer = first.size() >= second.size() ? first : second; // Split at keys of the longer list, so the ranges have similar sizes.
+	size_t rangeCount = min(size_t(8) * tasks.threadCount(), longer.size() / parallelGrain + 1); // Use about eight ranges per thread, but never ranges smaller than the grain.
+	vector<size_t> firstBounds(rangeCount + 1, first.size()); // Create a vector to store where each range starts in the first list.
+	vector<size_t> secondBounds(rangeCount + 1, second.size()); // Create a vector to store where each range starts in the second list.
+	firstBounds[0] = 0; // The first range starts at the front of the first list,
+	secondBounds[0] = 0; // and at the front of the second list.
+	for (size_t i = 1; i < rangeCount; ++i) { // Loop through the boundaries between ranges.
+		string_view boundary = longer[i * longer.size() / rangeCount]; // Every range starts at a key of the longer list.
+		firstBounds[i] = std::lower_bound(first.begin(), first.end(), boundary) - first.begin(); // Find where the range starts in the first list.
+		secondBounds[i] = std::lower_bound(second.begin(), second.end(), boundary) - second.begin(); // Find where the range starts in the second list.
+	}
+
+	vector<vector<string_view>> parts(rangeCount); // Create a vector to store the result of every range. Equal keys always fall into the same range.
+	tasks.parallelFor(0, rangeCount, 1, [&](size_t i) { // Combine every range on its own.
+		auto firstBegin = first.begin() + firstBounds[i]; // Get the start of the range in the first list.
+		auto firstEnd = first.begin() + firstBounds[i + 1]; // Get the end of the range in the first list.
+		auto secondBegin = second.begin() + secondBounds[i]; // Get the start of the range in the second list.
+		auto secondEnd = second.begin() + secondBounds[i + 1]; // Get the end of the range in the second list.
+		vector<string_view>& part = parts[i]; // Get the result of the range.
+		if (operation == SetOperation::Union) { // Keep the keys that are in either list.
+			part.reserve((firstEnd - firstBegin) + (secondEnd - secondBegin)); // Make room for all keys.
+			set_union(firstBegin, firstEnd, secondBegin, secondEnd, back_inserter(part)); // Merge the ranges, keeping every key once.
+		}
+		else if (operation == SetOperation::Intersection) { // Keep the keys that are in both lists.
+			part.reserve(min(firstEnd - firstBegin, secondEnd - secondBegin)); // Make room for the largest possible result.
+			set_intersection(firstBegin, firstEnd, secondBegin, secondEnd, back_inserter(part)); // Keep the keys found in both ranges.
+		}
+		else { // Keep the keys of the first list that are not in the second.
+			part.reserve(firstEnd - firstBegin); // Make room for the largest possible result.
+			set_difference(firstBegin, firstEnd, secondBegin, secondEnd, back_inserter(part)); // Keep the keys only found in the first range.
+		}
+	});
+	concatenate(parts, keys, tasks); // Put the ranges together.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::assignSetOperation(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, SetOperation operation, TaskPool& tasks) { // This function replaces the contents of the tree with the result of the set operation on two trees.
+	vector<string_view> firstKeys; // Create a vector to store the keys of the first tree.
+	vector<string_view> secondKeys; // Create a vector to store the keys of the second tree.
+	tasks.invoke([&]() { firstKeys = first.inorderKeys(&tasks); }, [&]() { secondKeys = second.inorderKeys(&tasks); }); // Collect the keys of both trees at the same time.
+	vector<string_view> keys; // Create a vector to store the result.
+	combineSorted(firstKeys, secondKeys, operation, keys, tasks); // Apply the set operation.
+	rebuild(keys, &tasks); // Build a balanced tree from the result. The old key pool is kept until the new one is full, so either tree may be this one.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::splitLines(string_view text, vector<string_view>& lines) { // This function splits the text into lines the way getline does, without copying them.
+	size_t start = 0; // Create an index for the start of the current line.
+	while (start < text.size()) { // Loop until the end of the text. A newline at the very end does not start another line.
+		size_t end = text.find('\n', start); // Find the end of the current line.
+		if (end == string_view::npos) { // If there is no newline, the line runs to the end of the text.
+			end = text.size(); // Use the end of the text.
+		}
+		size_t length = end - start; // Calculate the length of the line.
+		if (length > 0 && text[end - 1] == '\r') { // If the line ends with a carriage return from a Windows file, leave it out like text mode does.
+			--length; // Drop the carriage return.
+		}
+		lines.push_back(text.substr(start, length)); // Add a view of the line.
+		start = end + 1; // Move to the start of the next line.
+	}
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::bulkLoadFile(const string& filename) { // This function replaces the contents of the tree with the lines of the file. It returns false if the file cannot be opened.
+	MappedFile file; // Create the mapped file.
+	if (!file.open(filename)) { // If the file cannot be opened, report it to the caller.
+		return false; // Return false to indicate that the file could not be opened.
+	}
+	vector<string_view> lines; // Create a vector to store views of the lines.
+	splitLines(file.contents(), lines); // Split the mapped file into lines, without copying the characters.
+	loadSorted(lines); // Build the tree from the lines. The keys are copied into the key pool, so the file can be unmapped afterwards.
+	return true; // Return true to indicate that the file was loaded.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::saveSnapshot(const string& filename) const { // This function writes a read-only snapshot of the tree to a file that loadSnapshot or FrozenBinarySearchTree::open can map. It returns false if the file cannot be written.
+	return freeze().save(filename); // Freeze the tree and write the snapshot.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::loadSnapshot(const string& filename) { // This function replaces the contents of the tree with the keys of a saved snapshot. It returns false if the file cannot be mapped or is not a snapshot.
+	FrozenBinarySearchTree snapshot; // Create an empty snapshot.
+	if (!snapshot.open(filename)) { // If the snapshot cannot be opened, report it to the caller.
+		return false; // Return false to indicate that the file could not be loaded.
+	}
+	vector<string_view> keys = snapshot.sortedKeys(); // Read the keys in sorted order, straight from the mapped file.
+	loadSorted(keys); // Build the tree from the keys. They are already sorted and unique, so this only has to check the order.
+	return true; // Return true to indicate that the file was loaded.
+}
+
+template <template <typename> class Allocator>
+size_t BasicBinarySearchTree<Allocator>::keyBytes() const { // This function returns the number of bytes in the key pool.
+	return keyPool.size(); // Return the size of the key pool.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::assign(const BasicBinarySearchTree& other, TaskPool& tasks) { // This function replaces the contents of the tree with a balanced copy of the other tree, built on the given task pool.
+	if (this == &other) { // A tree is already a copy of itself.
+		return; // Return without changing anything.
+	}
+	mode = other.mode; // Use the balancing strategy of the other tree.
+	rebuild(other.inorderKeys(&tasks), &tasks); // Collect the keys of the other tree and build a balanced tree from them. The copy only holds live keys, so its pool is compact.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::equals(const BasicBinarySearchTree& other, TaskPool& tasks) const { // This function checks if both trees hold the same keys, comparing them on the given task pool.
+	if (this == &other) { // A tree always holds the same keys as itself.
+		return true; // Return true.
+	}
+	if (nodeCount != other.nodeCount) { // Trees of different sizes cannot hold the same keys.
+		return false; // Return false without looking at the keys.
+	}
+	vector<string_view> keys; // Create a vector to store the keys of this tree.
+	vector<string_view> otherKeys; // Create a vector to store the keys of the other tree.
+	tasks.invoke([&]() { keys = inorderKeys(&tasks); }, [&]() { otherKeys = other.inorderKeys(&tasks); }); // Collect the keys of both trees at the same time.
+	atomic<bool> same(true); // Create a flag that any thread can clear when it finds a difference.
+	size_t chunkCount = (nodeCount + parallelGrain - 1) / parallelGrain; // Compare the keys in chunks of the grain size.
+	tasks.parallelFor(0, chunkCount, 1, [&](size_t chunk) { // Compare every chunk on its own.
+		if (!same.load(memory_order_relaxed)) { // If another chunk already differs, the answer is known.
+			return; // Skip the chunk.
+		}
+		size_t first = chunk * parallelGrain; // Get the first key of the chunk.
+		size_t last = min(first + parallelGrain, nodeCount); // Get the end of the chunk.
+		if (!equal(keys.begin() + first, keys.begin() + last, otherKeys.begin() + first)) { // If any key of the chunk differs, the trees differ.
+			same.store(false, memory_order_relaxed); // Report the difference.
+		}
+	});
+	return same.load(); // Return the result.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::assignUnion(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, TaskPool& tasks) { // This function replaces the contents of the tree with the keys that are in either tree.
+	assignSetOperation(first, second, SetOperation::Union, tasks); // Keep the keys of both trees.
 }
 
-BinarySearchTree::~BinarySearchTree() { // This is the destructor for the binary search tree.
-	deleteTree(root); // Call the deleteTree function to delete the binary search tree.
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::assignIntersection(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, TaskPool& tasks) { // This function replaces the contents of the tree with the keys that are in both trees.
+	assignSetOperation(first, second, SetOperation::Intersection, tasks); // Keep the keys found in both trees.
 }
 
-void BinarySearchTree::deleteTree(Node* node) { // This function deletes the binary search tree.
-	if (node != nullptr) { // If the current node is not null, recursively delete the left and right subtrees, and delete the current node.
-		deleteTree(node->left); // Recursively delete the left subtree.
-		deleteTree(node->right); // Recursively delete the right subtree.
-		delete node; // Delete the current node.
-    }
-}
\ No newline at end of file
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::assignDifference(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, TaskPool& tasks) { // This function replaces the contents of the tree with the keys of the first tree that are not in the second.
+	assignSetOperation(first, second, SetOperation::Difference, tasks); // Keep the keys only found in the first tree.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::operator==(const BasicBinarySearchTree& other) const { // This function checks if two binary search trees hold the same keys, whatever their shape, comparing them on the shared task pool.
+	return equals(other); // Compare the keys on the shared task pool.
+}
+
+template <template <typename> class Allocator>
+bool BasicBinarySearchTree<Allocator>::operator!=(const BasicBinarySearchTree& other) const { // This function checks if two binary search trees hold different keys.
+	return !equals(other); // Return the opposite of the equality check.
+}
+
+template <template <typename> class Allocator>
+BasicBinarySearchTree<Allocator>::~BasicBinarySearchTree() { // This is the destructor for the binary search tree.
+	if (!Allocator<Node>::releasesAll) { // If the allocator cannot free all nodes at once, free them one at a time.
+		deleteTree(root); // Call the deleteTree function to delete the binary search tree.
+	} // Otherwise, the allocator frees all nodes at once when it is destroyed.
+}
+
+template <template <typename> class Allocator>
+void BasicBinarySearchTree<Allocator>::deleteTree(Node* node) { // This function deletes the binary search tree without recursion.
+	while (node != nullptr) { // Loop until every node has been deleted.
+		if (node->left != nullptr) { // If the node has a left child, rotate it up, so the nodes are freed without a stack.
+			Node* child = node->left; // Get the left child.
+			node->left = child->right; // Move the right subtree of the child under the node.
+			child->right = node; // Make the node the right child of the child.
+			node = child; // Continue at the child.
+		}
+		else { // Otherwise, the node can be freed and its right subtree is next.
+			Node* next = node->right; // Remember the right subtree.
+			nodes.deallocate(node); // Return the node to the allocator.
+			node = next; // Continue with the right subtree.
+		}
+	}
+}
+
+template <template <typename> class Allocator>
+istream& operator>>(istream& in, BasicBinarySearchTree<Allocator>& tree) { // This function overloads the input stream operator to read a binary search tree from a stream.
+	vector<string> words; // Create a vector to store the words.
+	string line; // Create a string to store each line.
+	while (getline(in, line)) { // Read the stream one line at a time until it ends.
+		if (!line.empty() && line.back() == '\r') { // If the line ends with a carriage return, it came from a Windows file.
+			line.pop_back(); // Remove the carriage return.
+		}
+		words.push_back(move(line)); // Store the word.
+	}
+	if (in.eof()) { // Reading stops at the end of the stream, which is not an error here.
+		in.clear(in.rdstate() & ~ios::failbit); // Clear the fail flag getline set at the end, but keep the end-of-file flag.
+	}
+	tree.bulkLoad(words.begin(), words.end()); // Replace the contents of the tree with the words.
+	return in; // Return the stream, so reads can be chained.
+}
+
+template <template <typename> class Allocator>
+ostream& operator<<(ostream& out, const BasicBinarySearchTree<Allocator>& tree) { // This function overloads the output stream operator to write a binary search tree to a stream.
+	tree.write(out, TraversalOrder::Inorder, '\n'); // Write the keys in sorted order, one per line, which is the format operator>> and bulkLoadFile read.
+	return out; // Return the stream, so writes can be chained.
+}
+
+template class BasicBinarySearchTree<NewAllocator>; // This creates the binary search tree that allocates every node with new.
+template class BasicBinarySearchTree<ArenaAllocator>; // This creates the binary search tree that takes its nodes from an arena.
+template class BasicBinarySearchTree<PoolAllocator>; // This creates the binary search tree that takes its nodes from a pool.
+
+template istream& operator>>(istream& in, BasicBinarySearchTree<NewAllocator>& tree); // This creates the input stream operator for the tree that allocates every node with new.
+template istream& operator>>(istream& in, BasicBinarySearchTree<ArenaAllocator>& tree); // This creates the input stream operator for the tree that takes its nodes from an arena.
+template istream& operator>>(istream& in, BasicBinarySearchTree<PoolAllocator>& tree); // This creates the input stream operator for the tree that takes its nodes from a pool.
+template ostream& operator<<(ostream& out, const BasicBinarySearchTree<NewAllocator>& tree); // This creates the output stream operator for the tree that allocates every node with new.
+template ostream& operator<<(ostream& out, const BasicBinarySearchTree<ArenaAllocator>& tree); // This creates the output stream operator for the tree that takes its nodes from an arena.
+template ostream& operator<<(ostream& out, const BasicBinarySearchTree<PoolAllocator>& tree); // This creates the output stream operator for the tree that takes its nodes from a pool.
@@ -7,46 +7,363 @@ operations such as insertion, removal, and traversal, while also including priva
 #pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
 #include <iostream> // This is a header file library that lets us work with input and output objects, such as cout.
 #include <string> // This is a header file library that lets us work with strings.
+#include <string_view> // This is a header file library that lets us refer to characters without copying them.
+#include <type_traits> // This is a header file library that lets us ask questions about types at compile time.
+#include <utility> // This is a header file library that lets us forward arguments with forward.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
 #include <chrono> // This is a header file library that lets us work with time.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <cstddef> // This is a header file library that lets us work with sizes and distances, such as ptrdiff_t.
+#include <iterator> // This is a header file library that lets us describe iterators, such as bidirectional_iterator_tag.
+#include "TreeOptions.h" // This is a header file that contains the balancing modes and traversal orders shared by the trees.
+#include "NodeAllocator.h" // This is a header file that contains the allocators the binary search tree can take its nodes from.
+#include "KeyPool.h" // This is a header file that contains the pool the binary search tree stores its keys in.
+#include "FrozenBinarySearchTree.h" // This is a header file that contains the read-only snapshot the binary search tree can be frozen into.
+#include "MappedFile.h" // This is a header file that contains the memory-mapped file the binary search tree loads files with.
+#include "TaskPool.h" // This is a header file that contains the task pool the parallel operations of the binary search tree run on.
+#include "TreeStatistics.h" // This is a header file that contains the statistics the binary search tree keeps when BST_ENABLE_STATS is defined.
+#include "TypedBinarySearchTree.h" // This is a header file that contains the binary search tree for keys of any type, which can also be a map.
+#include "BalancedTree.h" // This is a header file that contains the balancing core the binary search tree shares with the typed tree.
 
 using namespace std; // using standard namespace to avoid writing std:: before standard library functions
 using namespace chrono; // using chrono namespace to avoid writing chrono:: before time measurement functions
 
 struct Node { // This struct represents a node in a binary search tree.
-	string data; // This string represents the data stored in the node.
+	uint64_t prefix = 0; // This number stores the first eight bytes of the node's key, so most comparisons never read the key pool.
+	uint64_t offset = 0; // This number stores where the node's key starts in the key pool of the tree.
+	uint32_t length = 0; // This number stores the length of the node's key.
+	int16_t height = 1; // This integer stores the height of the subtree rooted at the node (used by AVL mode).
+	bool red = true; // This flag stores the color of the link from the parent to the node (used by red-black mode).
 	Node* left = nullptr; // This pointer points to the left child of the node.
 	Node* right = nullptr; // This pointer points to the right child of the node.
+
+	Node*& child(int side) { // This function returns the link to the left child for side 0 and to the right child for side 1, which is how the balancing core walks the tree.
+		return side == 0 ? left : right; // Return the link of the given side.
+	}
 };
 
-class BinarySearchTree { // This class represents a binary search tree.
+template <template <typename> class Allocator = PoolAllocator>
+class BasicBinarySearchTree : private BalancedTree<Node> { // This class represents a binary search tree that takes its nodes from the given allocator. The root, the mode and the balancing come from BalancedTree.
 private: // This section contains private members of the class.
-	Node* root; // This pointer points to the root node of the binary search tree.
+	Allocator<Node> nodes; // This allocator provides the memory for the nodes of the binary search tree.
+	KeyPool keyPool; // This pool stores the keys of all nodes in one contiguous block of characters.
+
+	int compareKey(const SearchKey& key, const Node* node) const; // This function compares the given key with the key of the node and returns a negative, zero or positive number.
+	string_view keyOf(const Node* node) const; // This function returns the key of the given node.
+	SearchKey searchKeyOf(const Node* node) const; // This function returns a search key for the key of the given node.
+	void compactKeys(); // This function rebuilds the key pool so it only holds the keys that are still in the tree.
+	enum class SetOperation { Union, Intersection, Difference }; // This enum selects which keys a set operation keeps.
+
+	vector<string_view> inorderKeys(TaskPool* tasks = nullptr) const; // This function returns the keys of the binary search tree in sorted order, collecting subtrees on several threads if a task pool is given.
+	static void sortUnique(vector<string_view>& keys); // This function sorts the keys and removes duplicates, skipping the sort if the keys are already sorted.
+	vector<Node*> takeNodes(size_t count); // This function returns the given number of nodes, reusing the nodes of the tree before taking new ones from the allocator. The tree's links are left dangling.
+	void rebuild(const vector<string_view>& sortedKeys, TaskPool* tasks = nullptr); // This function replaces the contents of the tree with a perfectly balanced tree of the given sorted, unique keys, filling and linking the nodes on several threads if a task pool is given.
+	static Node* buildBalanced(Node* const* slots, size_t first, size_t last, TaskPool* tasks); // This function links the nodes in [first, last), which hold the keys in sorted order, into a balanced subtree.
+	static Node* buildRedBlack(Node* const* slots, size_t first, size_t last, int blackHeight, TaskPool* tasks); // This function links the nodes in [first, last), which hold the keys in sorted order, into a left-leaning red-black subtree with the given black height.
+	void cloneFrom(const BasicBinarySearchTree& other, TaskPool& tasks); // This function replaces the contents of the tree with a copy of the other tree in the same shape, copying its subtrees on several threads.
+	static Node* cloneSubtree(const Node* source, Node* const* slots); // This function copies the subtree into the given nodes in preorder, keeping its shape, without recursion.
+	static Node* linkPieces(const Node* node, int depth, Node* const* copies, size_t& next); // This function links the copies of the pieces collectPieces made of the subtree the way the pieces were linked.
+	static size_t subtreeSize(const Node* node); // This function counts the nodes of the subtree without recursion.
+	static void copyNode(Node* target, const Node* source); // This function copies the key, height and color of the source node into the target node, and clears its links.
+	static void collectPieces(const Node* node, int depth, vector<pair<const Node*, bool>>& pieces); // This function splits the subtree into the nodes above the given depth and the whole subtrees below it, in sorted order. The flag is set for whole subtrees.
+	static void concatenate(vector<vector<string_view>>& parts, vector<string_view>& keys, TaskPool& tasks); // This function copies the parts one after another into the keys, on several threads.
+	static void combineSorted(const vector<string_view>& first, const vector<string_view>& second, SetOperation operation, vector<string_view>& keys, TaskPool& tasks); // This function applies the set operation to two sorted lists of keys, splitting them into ranges that are combined on several threads.
+	void assignSetOperation(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, SetOperation operation, TaskPool& tasks); // This function replaces the contents of the tree with the result of the set operation on two trees.
+	static int parallelDepth(const TaskPool& tasks); // This function returns how many levels of the tree are split into separate tasks, so every thread gets several subtrees.
+	void loadSorted(vector<string_view>& keys); // This function replaces the contents of the tree with the given keys.
+	void mergeSorted(vector<string_view>& keys); // This function adds the given keys to the tree, either one at a time or by merging and rebuilding.
+	static void splitLines(string_view text, vector<string_view>& lines); // This function splits the text into lines the way getline does, without copying them.
+	Node* findNode(const SearchKey& key) const; // This function finds the node with the given key in the binary search tree, or returns null.
+	string traversalString(TraversalOrder order) const; // This function returns the keys in the given order as one string, separated by spaces.
 
-	Node* insertRecursive(Node* node, string word); // This function inserts a node with the given word into the binary search tree.
-	Node* removeRecursive(Node* node, string word); // This function removes a node with the given word from the binary search tree.
-	Node* findMinNode(Node* node); // This function finds the node with the minimum value in the binary search tree.
-	Node* findRecursive(Node* node, string word) const; // This function finds a node with the given word in the binary search tree.
-	void inorderTraverseRecursive(Node* node, string& result) const; // This function traverses the binary search tree in inorder and stores the result in a string.
-	void preorderTraverseRecursive(Node* node, string& result) const; // This function traverses the binary search tree in preorder and stores the result in a string.
-	void postorderTraverseRecursive(Node* node, string& result) const; // This function traverses the binary search tree in postorder and stores the result in a string.
-	void deleteTree(Node* node); // This function deletes the binary search tree.
+	template <typename Visitor>
+	void forEachInorder(const Node* node, Visitor& visit) const { // This function calls visit with every key of the subtree in sorted order, without recursion.
+		vector<const Node*> stack; // Create a stack of nodes whose left subtree is being visited.
+		while (node != nullptr || !stack.empty()) { // Loop until every node has been visited.
+			for (; node != nullptr; node = node->left) { // Walk down to the smallest node of the current subtree.
+				stack.push_back(node); // Remember the node, so it can be visited after its left subtree.
+			}
+			node = stack.back(); // Take the smallest node that has not been visited yet.
+			stack.pop_back(); // Remove the node from the stack.
+			visit(keyOf(node)); // Visit the key.
+			node = node->right; // Visit the right subtree next.
+		}
+	}
+
+	template <typename T, typename Map, typename Combine>
+	T foldSubtree(const Node* node, const T& identity, const Map& map, const Combine& combine, TaskPool& tasks, int depth) const { // This function folds the keys of the subtree, splitting the top levels into tasks.
+		if (depth == 0 || node == nullptr) { // Below the split levels, one thread folds the whole subtree.
+			T result = identity; // Start with the identity.
+			auto visit = [&](string_view key) { result = combine(move(result), map(key)); }; // Create a visitor that adds one key to the result.
+			forEachInorder(node, visit); // Visit the keys in sorted order.
+			return result; // Return the folded subtree.
+		}
+		T left = identity; // Create a variable to store the folded left subtree.
+		T right = identity; // Create a variable to store the folded right subtree.
+		tasks.invoke([&]() { left = foldSubtree(node->left, identity, map, combine, tasks, depth - 1); }, // Fold the left subtree here,
+			[&]() { right = foldSubtree(node->right, identity, map, combine, tasks, depth - 1); }); // and the right subtree here or on another thread.
+		return combine(combine(move(left), map(keyOf(node))), move(right)); // Combine the parts in sorted order, so combine does not have to be commutative.
+	}
+	void deleteTree(Node* node); // This function deletes the binary search tree without recursion.
 
 public: // This section contains public members of the class.
-	BinarySearchTree(); // This is the default constructor for the binary search tree.
-	BinarySearchTree(string word); // This is a constructor that initializes the binary search tree with a single node containing the given word.
-	BinarySearchTree(const BinarySearchTree& rhs); // This is the copy constructor for the binary search tree.
-	~BinarySearchTree(); // This is the destructor for the binary search tree.
-
-	void insert(string word); // This function inserts a node with the given word into the binary search tree.
-	bool remove(string word); // This function removes a node with the given word from the binary search tree.
-	bool exists(string word) const; // This function checks if a node with the given word exists in the binary search tree.
+	class const_iterator { // This class walks the keys of the tree in sorted order, in both directions. Changing the tree invalidates it.
+	public: // This section contains public members of the class.
+		using iterator_category = bidirectional_iterator_tag; // The iterator can move forward and backward.
+		using value_type = string_view; // The iterator gives views of the keys.
+		using difference_type = ptrdiff_t; // This is the type of the distance between two iterators.
+		using pointer = const string_view*; // This is the pointer type standard algorithms expect.
+		using reference = string_view; // The keys are returned by value, because they are views into the key pool.
+
+		const_iterator() : tree(nullptr) {} // This is the default constructor for an iterator that does not point into any tree.
+
+		string_view operator*() const { // This function returns the key the iterator points to.
+			return tree->keyOf(path.back()); // Return the key of the current node.
+		}
+
+		const_iterator& operator++() { // This function moves the iterator to the next larger key.
+			const Node* node = path.back(); // Get the current node.
+			if (node->right != nullptr) { // If the node has a right subtree, the next key is the smallest key in it.
+				descendLeft(node->right); // Walk down to the smallest key of the right subtree.
+				return *this; // Return the moved iterator.
+			}
+			climbFrom(&Node::right); // Otherwise, climb up until the walk comes up from a left child.
+			return *this; // Return the moved iterator.
+		}
+
+		const_iterator& operator--() { // This function moves the iterator to the next smaller key. Moving back from end gives the largest key.
+			if (path.empty()) { // If the iterator is at the end, the previous key is the largest key of the tree.
+				descendRight(tree->root); // Walk down to the largest key.
+				return *this; // Return the moved iterator.
+			}
+			const Node* node = path.back(); // Get the current node.
+			if (node->left != nullptr) { // If the node has a left subtree, the previous key is the largest key in it.
+				descendRight(node->left); // Walk down to the largest key of the left subtree.
+				return *this; // Return the moved iterator.
+			}
+			climbFrom(&Node::left); // Otherwise, climb up until the walk comes up from a right child.
+			return *this; // Return the moved iterator.
+		}
+
+		const_iterator operator++(int) { // This function moves the iterator forward and returns its old position.
+			const_iterator old = *this; // Remember the old position.
+			++*this; // Move the iterator.
+			return old; // Return the old position.
+		}
+
+		const_iterator operator--(int) { // This function moves the iterator backward and returns its old position.
+			const_iterator old = *this; // Remember the old position.
+			--*this; // Move the iterator.
+			return old; // Return the old position.
+		}
+
+		bool operator==(const const_iterator& other) const { // This function checks if two iterators point to the same key.
+			return current() == other.current(); // Compare the current nodes. All end iterators have no current node.
+		}
+
+		bool operator!=(const const_iterator& other) const { // This function checks if two iterators point to different keys.
+			return !(*this == other); // Return the opposite of the equality check.
+		}
+
+	private: // This section contains private members of the class.
+		friend class BasicBinarySearchTree; // The tree builds iterators that point to a given node.
+
+		const BasicBinarySearchTree* tree; // This pointer points to the tree the iterator walks.
+		vector<const Node*> path; // This vector stores the nodes from the root to the current node. It is empty at the end.
+
+		explicit const_iterator(const BasicBinarySearchTree* tree) : tree(tree) {} // This is a constructor for an iterator at the end of the given tree.
+
+		const Node* current() const { // This function returns the current node, or null at the end.
+			return path.empty() ? nullptr : path.back(); // Return the last node of the path.
+		}
+
+		void descendLeft(const Node* node) { // This function walks down from the node to the smallest key of its subtree.
+			for (; node != nullptr; node = node->left) { // Loop until there is no left child.
+				path.push_back(node); // Add the node to the path.
+			}
+		}
+
+		void descendRight(const Node* node) { // This function walks down from the node to the largest key of its subtree.
+			for (; node != nullptr; node = node->right) { // Loop until there is no right child.
+				path.push_back(node); // Add the node to the path.
+			}
+		}
+
+		void climbFrom(Node* Node::*side) { // This function climbs up while the walk comes up from the given side, and stops at the first parent reached from the other side.
+			const Node* child = path.back(); // Get the node the walk starts from.
+			path.pop_back(); // Leave the node.
+			while (!path.empty() && path.back()->*side == child) { // Keep climbing while the walk comes up from the given side.
+				child = path.back(); // Move up to the parent.
+				path.pop_back(); // Leave the parent.
+			}
+		}
+	};
+	using iterator = const_iterator; // The keys cannot be changed in place, so both iterator types are the same.
+
+	BasicBinarySearchTree(); // This is the default constructor for the binary search tree.
+	explicit BasicBinarySearchTree(BalanceMode mode); // This is a constructor that creates an empty binary search tree with the given balancing strategy.
+	explicit BasicBinarySearchTree(string_view word); // This is a constructor that initializes the binary search tree with a single node containing the given word.
+	BasicBinarySearchTree(const BasicBinarySearchTree& rhs); // This is the copy constructor for the binary search tree. The copy has the same shape, so its traversals and height match, and subtrees are copied on the shared task pool.
+	BasicBinarySearchTree& operator=(const BasicBinarySearchTree& rhs); // This is the copy assignment operator for the binary search tree. The copy has the same shape, and subtrees are copied on the shared task pool.
+	~BasicBinarySearchTree(); // This is the destructor for the binary search tree.
+
+	void insert(string_view word); // This function inserts a node with the given word into the binary search tree. Strings, string views and C strings are accepted without copying.
+	bool remove(string_view word); // This function removes a node with the given word from the binary search tree.
+	bool exists(string_view word) const; // This function checks if a node with the given word exists in the binary search tree.
+
+	template <typename... Args>
+	void emplace(Args&&... args) { // This function builds a word from the given arguments and inserts it into the binary search tree.
+		if constexpr (is_constructible<string_view, Args&&...>::value) { // If the arguments already describe characters, such as a pointer and a length, refer to them directly.
+			insert(string_view(forward<Args>(args)...)); // Insert the characters without building a string.
+		}
+		else { // Otherwise, the word has to be built first, for example from a count and a character.
+			insert(string(forward<Args>(args)...)); // Build the word and insert it. The key pool copies it, so the temporary is freed right away.
+		}
+	}
 	string inorder() const; // This function returns the inorder traversal of the binary search tree as a string.
 	string preorder() const; // This function returns the preorder traversal of the binary search tree as a string.
 	string postorder() const; // This function returns the postorder traversal of the binary search tree as a string.
+	int height() const; // This function returns the number of nodes on the longest path from the root to a leaf.
+	BalanceMode balanceMode() const; // This function returns the balancing strategy used by the binary search tree.
+	size_t keyBytes() const; // This function returns the number of bytes in the key pool.
+	size_t size() const; // This function returns the number of words in the binary search tree.
+	FrozenBinarySearchTree freeze() const; // This function builds a read-only snapshot of the binary search tree that answers exists faster.
+
+	const_iterator begin() const; // This function returns an iterator to the smallest key.
+	const_iterator end() const; // This function returns an iterator past the largest key.
+	const_iterator find(string_view word) const; // This function returns an iterator to the given word, or end if the word is not in the tree.
+	const_iterator lower_bound(string_view word) const; // This function returns an iterator to the smallest key that is not less than the word.
+	const_iterator upper_bound(string_view word) const; // This function returns an iterator to the smallest key that is greater than the word.
+	void write(ostream& out, TraversalOrder order = TraversalOrder::Inorder, char separator = ' ') const; // This function writes the keys to the stream in the given order, each followed by the separator, without building a string.
+
+	template <typename Visitor>
+	void forEach(TraversalOrder order, Visitor visit) const { // This function calls visit with every key in the given order, without recursion.
+		vector<const Node*> stack; // Create a stack of nodes that still have to be visited or finished.
+		const Node* node = root; // Start at the root.
+		if (order == TraversalOrder::Inorder) { // Visit the left subtree, then the node, then the right subtree.
+			forEachInorder(node, visit); // Visit the keys in sorted order.
+		}
+		else if (order == TraversalOrder::Preorder) { // Visit the node, then the left subtree, then the right subtree.
+			if (node != nullptr) { // If the tree is not empty, start at the root.
+				stack.push_back(node); // Add the root to the stack.
+			}
+			while (!stack.empty()) { // Loop until every node has been visited.
+				node = stack.back(); // Take the next node.
+				stack.pop_back(); // Remove the node from the stack.
+				visit(keyOf(node)); // Visit the key.
+				if (node->right != nullptr) { // Push the right child first, so the left child is visited first.
+					stack.push_back(node->right); // Add the right child to the stack.
+				}
+				if (node->left != nullptr) { // Push the left child last, so it is visited next.
+					stack.push_back(node->left); // Add the left child to the stack.
+				}
+			}
+		}
+		else { // Visit the left subtree, then the right subtree, then the node.
+			const Node* finished = nullptr; // Create a pointer to the node that was visited last.
+			while (node != nullptr || !stack.empty()) { // Loop until every node has been visited.
+				for (; node != nullptr; node = node->left) { // Walk down the left side of the current subtree.
+					stack.push_back(node); // Remember the node, so it can be visited after both subtrees.
+				}
+				const Node* top = stack.back(); // Get the deepest node whose left subtree is done.
+				if (top->right != nullptr && top->right != finished) { // If its right subtree has not been visited yet, visit it first.
+					node = top->right; // Move to the right subtree.
+				}
+				else { // Otherwise, both subtrees are done.
+					visit(keyOf(top)); // Visit the key.
+					finished = top; // Remember the node, so its parent knows its right subtree is done.
+					stack.pop_back(); // Remove the node from the stack.
+				}
+			}
+		}
+	}
+
+	template <typename Visitor>
+	void forEach(Visitor visit) const { // This function calls visit with every key in sorted order.
+		forEach(TraversalOrder::Inorder, visit); // Visit the keys in inorder.
+	}
+
+	template <typename Visitor>
+	void range(string_view low, string_view high, Visitor visit) const { // This function calls visit with every key from low to high, both included, in sorted order. Subtrees outside the range are never entered.
+		SearchKey lowKey = KeyPool::makeSearchKey(low); // Create a search key for the lower end, so its prefix is only computed once.
+		SearchKey highKey = KeyPool::makeSearchKey(high); // Create a search key for the upper end, so its prefix is only computed once.
+		vector<const Node*> stack; // Create a stack of nodes in the range whose left subtree is being visited.
+		const Node* node = root; // Start at the root.
+		while (node != nullptr || !stack.empty()) { // Loop until the range is done.
+			while (node != nullptr) { // Walk down to the smallest node of the current subtree that can be in the range.
+				if (compareKey(lowKey, node) > 0) { // If the node is below the range, so is its left subtree.
+					node = node->right; // Skip the node and its left subtree.
+				}
+				else { // Otherwise, the node may be in the range.
+					stack.push_back(node); // Remember the node, so it can be visited after its left subtree.
+					node = node->left; // Move to the left child.
+				}
+			}
+			if (stack.empty()) { // If no node is left, the range is done.
+				return; // Stop the walk.
+			}
+			node = stack.back(); // Take the smallest node that has not been visited yet.
+			stack.pop_back(); // Remove the node from the stack.
+			if (compareKey(highKey, node) < 0) { // If the node is above the range, every node that is left is too.
+				return; // Stop the walk.
+			}
+			visit(keyOf(node)); // Visit the key.
+			node = node->right; // Visit the right subtree next.
+		}
+	}
+
+	template <typename Iterator>
+	void bulkLoad(Iterator first, Iterator last) { // This function replaces the contents of the tree with the words in the range and builds a perfectly balanced tree in linear time once they are sorted.
+		vector<string_view> keys; // Create a vector to store views of the words. The words must stay alive until the function returns.
+		for (; first != last; ++first) { // Loop through the words.
+			keys.emplace_back(*first); // Add a view of the word to the vector.
+		}
+		loadSorted(keys); // Sort the words and build the tree.
+	}
+
+	template <typename Iterator>
+	void insertMany(Iterator first, Iterator last) { // This function inserts all words in the range, merging them into the tree in linear time when the batch is large.
+		vector<string_view> keys; // Create a vector to store views of the words. The words must stay alive until the function returns.
+		for (; first != last; ++first) { // Loop through the words.
+			keys.emplace_back(*first); // Add a view of the word to the vector.
+		}
+		mergeSorted(keys); // Sort the words and merge them into the tree.
+	}
+
+	bool bulkLoadFile(const string& filename); // This function replaces the contents of the tree with the lines of the file. It returns false if the file cannot be opened.
+	bool saveSnapshot(const string& filename) const; // This function writes a read-only snapshot of the tree to a file that loadSnapshot or FrozenBinarySearchTree::open can map. It returns false if the file cannot be written.
+	bool loadSnapshot(const string& filename); // This function replaces the contents of the tree with the keys of a saved snapshot. It returns false if the file cannot be mapped or is not a snapshot.
+
+	template <typename T, typename Map, typename Combine>
+	T fold(T identity, Map map, Combine combine, TaskPool& tasks = TaskPool::shared()) const { // This function maps every key and combines the results in sorted order, folding subtrees on several threads. Map and combine are called from several threads at once, combine must be associative, and identity must leave every value unchanged.
+		return foldSubtree(root, identity, map, combine, tasks, parallelDepth(tasks)); // Fold the whole tree.
+	}
+
+	template <typename Predicate>
+	size_t countIf(Predicate predicate, TaskPool& tasks = TaskPool::shared()) const { // This function counts the keys the predicate accepts, on several threads. The predicate is called from several threads at once.
+		return fold(size_t(0), [&predicate](string_view key) -> size_t { return predicate(key) ? 1 : 0; }, // Count 1 for every accepted key,
+			[](size_t left, size_t right) { return left + right; }, tasks); // and add up the counts.
+	}
+
+	void assign(const BasicBinarySearchTree& other, TaskPool& tasks = TaskPool::shared()); // This function replaces the contents of the tree with a balanced copy of the other tree, built on the given task pool. Unlike the copy constructor, it does not keep the shape, and the copy's key pool only holds live keys.
+	bool equals(const BasicBinarySearchTree& other, TaskPool& tasks = TaskPool::shared()) const; // This function checks if both trees hold the same keys, comparing them on the given task pool.
+	void assignUnion(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, TaskPool& tasks = TaskPool::shared()); // This function replaces the contents of the tree with the keys that are in either tree. Either tree may be this one.
+	void assignIntersection(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, TaskPool& tasks = TaskPool::shared()); // This function replaces the contents of the tree with the keys that are in both trees. Either tree may be this one.
+	void assignDifference(const BasicBinarySearchTree& first, const BasicBinarySearchTree& second, TaskPool& tasks = TaskPool::shared()); // This function replaces the contents of the tree with the keys of the first tree that are not in the second. Either tree may be this one.
+
+	bool operator==(const BasicBinarySearchTree& other) const; // This function checks if two binary search trees hold the same keys, whatever their shape, comparing them on the shared task pool.
+	bool operator!=(const BasicBinarySearchTree& other) const; // This function checks if two binary search trees hold different keys.
+
+#ifdef BST_ENABLE_STATS
+	TreeStatistics statistics() const; // This function returns a snapshot of the operation counters, the comparison histogram and the memory of the tree. It does not walk the tree.
+	TreeShape shape() const; // This function walks the tree and returns its height, average depth and largest imbalance.
+	void resetStatistics(); // This function sets the operation counters and the comparison histogram back to zero.
+#endif
+};
 
-	bool operator==(const BinarySearchTree& other) const; // This function checks if two binary search trees are equal.
-	bool operator!=(const BinarySearchTree& other) const; // This function checks if two binary search trees are not equal.
+template <template <typename> class Allocator>
+istream& operator>>(istream& in, BasicBinarySearchTree<Allocator>& tree); // This function overloads the input stream operator to read a binary search tree from a stream.
+template <template <typename> class Allocator>
+ostream& operator<<(ostream& out, const BasicBinarySearchTree<Allocator>& tree); // This function overloads the output stream operator to write a binary search tree to a stream.
 
-	friend istream& operator>>(istream& in, BinarySearchTree& tree); // This function overloads the input stream operator to read a binary search tree from a stream.
-	friend ostream& operator<<(ostream& out, const BinarySearchTree& tree); // This function overloads the output stream operator to write a binary search tree to a stream.
-};
\ No newline at end of file
+using BinarySearchTree = BasicBinarySearchTree<PoolAllocator>; // This is the binary search tree used by default. It takes its nodes from a pool. Sets and maps of other key types use TypedBinarySearchTree.
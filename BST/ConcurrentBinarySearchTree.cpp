@@ -0,0 +1,260 @@
+/*
+This implementation file provides the implementations for the concurrent Binary Search Tree (BST) declared in the header file. Every change builds a
+new version of the path from the root to the changed node, and the AVL rotations are applied to that new version, so the published tree is never touched.
+*/
+
+#include "ConcurrentBinarySearchTree.h" // This is a header file that contains the declaration of the concurrent binary search tree.
+#include <algorithm> // This is a header file library that lets us use algorithms such as max and min.
+#include <cstring> // This is a header file library that lets us compare and copy raw memory.
+
+static void deleteText(void* text) { // This function deletes the characters of a removed key once the reclaimer allows it.
+	delete[] static_cast<char*>(text); // Delete the characters.
+}
+
+ConcurrentBinarySearchTree::ConcurrentBinarySearchTree() : root(nullptr), nodeCount(0) {} // This is the default constructor for an empty tree.
+
+ConcurrentBinarySearchTree::~ConcurrentBinarySearchTree() { // This is the destructor. No other thread may use the tree when it runs.
+	deleteTree(root.load()); // Delete the current version. The replaced nodes are deleted by the reclaimer when it is destroyed.
+}
+
+int ConcurrentBinarySearchTree::compareKey(const SearchKey& key, const ConcurrentNode* node) const { // This function compares the search key with the key of the node and returns a negative, zero or positive number.
+	if (key.prefix != node->prefix) { // If the first eight bytes differ, the prefixes alone decide the order.
+		return key.prefix < node->prefix ? -1 : 1; // Return the order of the prefixes.
+	}
+	size_t common = min<size_t>(key.text.size(), node->length); // Calculate the number of characters both keys have.
+	if (common > 8) { // If both keys are longer than the prefix, compare the rest of the characters.
+		int result = memcmp(key.text.data() + 8, node->text + 8, common - 8); // Compare the characters after the prefix.
+		if (result != 0) { // If the characters differ, they decide the order.
+			return result; // Return the order of the characters.
+		}
+	}
+	if (key.text.size() == node->length) { // If all shared characters are equal and the keys have the same length, the keys are equal.
+		return 0; // Return 0 to indicate that the keys are equal.
+	}
+	return key.text.size() < node->length ? -1 : 1; // Otherwise, the shorter key comes first.
+}
+
+int ConcurrentBinarySearchTree::nodeHeight(const ConcurrentNode* node) { // This function returns the height of the subtree rooted at the given node, or 0 for an empty subtree.
+	return node == nullptr ? 0 : node->height; // An empty subtree has height 0.
+}
+
+void ConcurrentBinarySearchTree::updateHeight(ConcurrentNode* node) { // This function recalculates the height of the node from the heights of its children.
+	node->height = static_cast<int16_t>(1 + max(nodeHeight(node->left), nodeHeight(node->right))); // The node is one level above its taller child.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::writable(ConcurrentNode* node, Update& update) { // This function returns a node the update may change: the node itself if the update created it, otherwise a copy.
+	if (node->fresh) { // If the update created the node, nobody else can see it yet.
+		return node; // Return the node itself.
+	}
+	ConcurrentNode* copy = new ConcurrentNode(*node); // Copy the published node. The copy shares the characters of the key.
+	copy->fresh = true; // Mark the copy as part of the update.
+	update.created.push_back(copy); // Remember the copy, so it can be deleted if the update fails.
+	update.replaced.push_back(node); // Remember the published node, so it can be retired if the update succeeds.
+	return copy; // Return the copy.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::rotateLeft(ConcurrentNode* node, Update& update) { // This function rotates the subtree rooted at the node to the left.
+	ConcurrentNode* child = writable(node->right, update); // Get a version of the right child that can be changed.
+	node->right = child->left; // Move the left subtree of the child under the node.
+	child->left = node; // Make the node the left child of the child.
+	updateHeight(node); // Recalculate the height of the node, which is now lower.
+	updateHeight(child); // Recalculate the height of the child, which is now the root of the subtree.
+	return child; // Return the new root of the subtree.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::rotateRight(ConcurrentNode* node, Update& update) { // This function rotates the subtree rooted at the node to the right.
+	ConcurrentNode* child = writable(node->left, update); // Get a version of the left child that can be changed.
+	node->left = child->right; // Move the right subtree of the child under the node.
+	child->right = node; // Make the node the right child of the child.
+	updateHeight(node); // Recalculate the height of the node, which is now lower.
+	updateHeight(child); // Recalculate the height of the child, which is now the root of the subtree.
+	return child; // Return the new root of the subtree.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::rebalance(ConcurrentNode* node, Update& update) { // This function restores the AVL balance of a node the update may change.
+	updateHeight(node); // Recalculate the height of the node.
+	int balance = nodeHeight(node->left) - nodeHeight(node->right); // Calculate how much taller the left subtree is.
+	if (balance > 1) { // If the left subtree is too tall, rotate to the right.
+		if (nodeHeight(node->left->left) < nodeHeight(node->left->right)) { // If the left child leans to the right, rotate it first.
+			node->left = rotateLeft(writable(node->left, update), update); // Rotate the left child to the left.
+		}
+		return rotateRight(node, update); // Rotate the node to the right.
+	}
+	if (balance < -1) { // If the right subtree is too tall, rotate to the left.
+		if (nodeHeight(node->right->right) < nodeHeight(node->right->left)) { // If the right child leans to the left, rotate it first.
+			node->right = rotateRight(writable(node->right, update), update); // Rotate the right child to the right.
+		}
+		return rotateLeft(node, update); // Rotate the node to the left.
+	}
+	return node; // The node is balanced.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::insertRecursive(ConcurrentNode* node, const SearchKey& key, const char* text, Update& update) const { // This function returns the new version of the subtree with the key inserted, or the same subtree if the key is already in it.
+	if (node == nullptr) { // If the subtree is empty, the key goes here.
+		ConcurrentNode* leaf = new ConcurrentNode{ key.prefix, text, static_cast<uint32_t>(key.text.size()), 1, true, nullptr, nullptr }; // Create the new node.
+		update.created.push_back(leaf); // Remember the node, so it can be deleted if the update fails.
+		return leaf; // Return the new node.
+	}
+	int order = compareKey(key, node); // Compare the key with the key of the node.
+	if (order == 0) { // If the key is already in the tree, nothing changes.
+		return node; // Return the subtree unchanged.
+	}
+	ConcurrentNode* child = insertRecursive(order < 0 ? node->left : node->right, key, text, update); // Insert the key into the subtree it belongs to.
+	if (child == (order < 0 ? node->left : node->right)) { // If the subtree did not change, the node does not change either.
+		return node; // Return the subtree unchanged.
+	}
+	ConcurrentNode* copy = writable(node, update); // Get a version of the node that can point to the new subtree.
+	(order < 0 ? copy->left : copy->right) = child; // Point to the new subtree.
+	return rebalance(copy, update); // Restore the balance of the node.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::removeMin(ConcurrentNode* node, ConcurrentNode*& minimum, Update& update) { // This function returns the new version of the subtree without its smallest node, and stores that node in minimum.
+	if (node->left == nullptr) { // If the node has no left child, it holds the smallest key.
+		minimum = node; // Store the node.
+		update.replaced.push_back(node); // The node leaves the tree, but its key moves to another node, so only the node is retired.
+		return node->right; // Replace the node with its right subtree.
+	}
+	ConcurrentNode* child = removeMin(node->left, minimum, update); // Remove the smallest node from the left subtree.
+	ConcurrentNode* copy = writable(node, update); // Get a version of the node that can point to the new subtree.
+	copy->left = child; // Point to the new subtree.
+	return rebalance(copy, update); // Restore the balance of the node.
+}
+
+ConcurrentNode* ConcurrentBinarySearchTree::removeRecursive(ConcurrentNode* node, const SearchKey& key, Update& update) const { // This function returns the new version of the subtree with the key removed, or the same subtree if the key is not in it.
+	if (node == nullptr) { // If the subtree is empty, the key is not in the tree.
+		return nullptr; // Return the empty subtree.
+	}
+	int order = compareKey(key, node); // Compare the key with the key of the node.
+	if (order != 0) { // If the key is not in this node, remove it from the subtree it belongs to.
+		ConcurrentNode* child = removeRecursive(order < 0 ? node->left : node->right, key, update); // Remove the key from the subtree.
+		if (child == (order < 0 ? node->left : node->right)) { // If the subtree did not change, the node does not change either.
+			return node; // Return the subtree unchanged.
+		}
+		ConcurrentNode* copy = writable(node, update); // Get a version of the node that can point to the new subtree.
+		(order < 0 ? copy->left : copy->right) = child; // Point to the new subtree.
+		return rebalance(copy, update); // Restore the balance of the node.
+	}
+	update.removedText = node->text; // The key of this node leaves the tree.
+	if (node->left == nullptr || node->right == nullptr) { // If the node has at most one child, the child takes its place.
+		update.replaced.push_back(node); // Retire the node.
+		return node->left != nullptr ? node->left : node->right; // Return the child, or an empty subtree.
+	}
+	ConcurrentNode* successor = nullptr; // Create a variable to store the node with the next larger key.
+	ConcurrentNode* right = removeMin(node->right, successor, update); // Take the successor out of the right subtree.
+	ConcurrentNode* copy = writable(node, update); // Get a version of the node that can take the key of the successor.
+	copy->prefix = successor->prefix; // Take the prefix of the successor.
+	copy->text = successor->text; // Take the characters of the successor.
+	copy->length = successor->length; // Take the length of the successor.
+	copy->right = right; // Point to the right subtree without the successor.
+	return rebalance(copy, update); // Restore the balance of the node.
+}
+
+bool ConcurrentBinarySearchTree::publish(ConcurrentNode* expected, ConcurrentNode* desired, Update& update) { // This function swaps the root to the new version if it is still the expected one, and cleans up after the attempt either way.
+	for (ConcurrentNode* node : update.created) { // Loop through the nodes the attempt created.
+		node->fresh = false; // Once published, the nodes must never be changed again. The swap below makes this write visible to other writers.
+	}
+	bool published = root.compare_exchange_strong(expected, desired, memory_order_acq_rel, memory_order_acquire); // Swap the root if no other writer changed it.
+	if (published) { // If the new version is now the tree, the replaced nodes are garbage.
+		for (ConcurrentNode* node : update.replaced) { // Loop through the replaced nodes.
+			reclaimer.retire(node); // Delete the node once no reader can still see it.
+		}
+		if (update.removedText != nullptr) { // If a key was removed, its characters are garbage too.
+			reclaimer.retire(const_cast<char*>(update.removedText), deleteText); // Delete the characters once no reader can still see them.
+		}
+	}
+	else { // Otherwise, nobody has seen the new nodes, so they can be deleted right away.
+		for (ConcurrentNode* node : update.created) { // Loop through the nodes the attempt created.
+			delete node; // Delete the node. Its characters belong to another node or to the caller.
+		}
+	}
+	update.created.clear(); // Forget the created nodes.
+	update.replaced.clear(); // Forget the replaced nodes.
+	update.removedText = nullptr; // Forget the removed key.
+	return published; // Return whether the update was published.
+}
+
+bool ConcurrentBinarySearchTree::insert(string_view word) { // This function inserts the word. It returns false if the word was already in the tree.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	char* text = new char[word.size()]; // Copy the characters of the word, so the tree owns them.
+	memcpy(text, word.data(), word.size()); // Copy the characters.
+	EpochReclaimer::Guard guard(reclaimer); // Keep the nodes of the version being copied alive until the update is done.
+	Update update; // Create a record of the nodes the update touches.
+	while (true) { // Try until the update is published or there is nothing to do.
+		ConcurrentNode* current = root.load(memory_order_acquire); // Get the current version.
+		ConcurrentNode* updated = insertRecursive(current, key, text, update); // Build the new version.
+		if (updated == current) { // If the word is already in the tree, nothing changes.
+			delete[] text; // Delete the unused characters.
+			return false; // Return false to indicate that the word was already in the tree.
+		}
+		if (publish(current, updated, update)) { // If the new version was published, the word is in the tree.
+			nodeCount.fetch_add(1, memory_order_relaxed); // Count the word.
+			return true; // Return true to indicate that the word was inserted.
+		}
+	}
+}
+
+bool ConcurrentBinarySearchTree::remove(string_view word) { // This function removes the word. It returns false if the word was not in the tree.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	EpochReclaimer::Guard guard(reclaimer); // Keep the nodes of the version being copied alive until the update is done.
+	Update update; // Create a record of the nodes the update touches.
+	while (true) { // Try until the update is published or there is nothing to do.
+		ConcurrentNode* current = root.load(memory_order_acquire); // Get the current version.
+		ConcurrentNode* updated = removeRecursive(current, key, update); // Build the new version.
+		if (updated == current) { // If the word is not in the tree, nothing changes.
+			return false; // Return false to indicate that the word was not in the tree.
+		}
+		if (publish(current, updated, update)) { // If the new version was published, the word is gone.
+			nodeCount.fetch_sub(1, memory_order_relaxed); // Stop counting the word.
+			return true; // Return true to indicate that the word was removed.
+		}
+	}
+}
+
+bool ConcurrentBinarySearchTree::exists(string_view word) const { // This function checks if the word is in the tree, without taking a lock.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	EpochReclaimer::Guard guard(reclaimer); // Keep the nodes alive until the lookup is done.
+	const ConcurrentNode* node = root.load(memory_order_acquire); // Start at the root of the current version.
+	while (node != nullptr) { // Walk down until the word is found or the subtree is empty.
+		int order = compareKey(key, node); // Compare the word with the key of the node.
+		if (order == 0) { // If the keys are equal, the word is in the tree.
+			return true; // Return true to indicate that the word was found.
+		}
+		node = order < 0 ? node->left : node->right; // Move to the subtree the word belongs to.
+	}
+	return false; // Return false to indicate that the word was not found.
+}
+
+string ConcurrentBinarySearchTree::inorder() const { // This function returns the keys of one version of the tree in sorted order, separated by spaces, without taking a lock.
+	string result; // Create an empty string to store the traversal result.
+	forEach([&result](string_view key) { // Visit the keys in sorted order.
+		result += key; // Append the key to the result string.
+		result += ' '; // Separate the key from the next one.
+	});
+	return result; // Return the traversal result.
+}
+
+int ConcurrentBinarySearchTree::height() const { // This function returns the height of the current version of the tree.
+	EpochReclaimer::Guard guard(reclaimer); // Keep the root alive while its height is read.
+	return nodeHeight(root.load(memory_order_acquire)); // Every node stores the height of its subtree.
+}
+
+size_t ConcurrentBinarySearchTree::size() const { // This function returns the number of keys in the tree. While writers are running, it may be slightly behind.
+	return nodeCount.load(memory_order_relaxed); // Return the number of keys.
+}
+
+size_t ConcurrentBinarySearchTree::pendingReclaim() const { // This function returns the number of replaced nodes and keys that have not been deleted yet.
+	return reclaimer.pendingCount(); // Return the number of objects waiting in the reclaimer.
+}
+
+void ConcurrentBinarySearchTree::reclaim() { // This function deletes the replaced nodes and keys that no reader can still see.
+	reclaimer.collect(); // Collect the objects of every thread, including threads that have ended.
+}
+
+void ConcurrentBinarySearchTree::deleteTree(ConcurrentNode* node) { // This function deletes the nodes and the keys of the given subtree.
+	if (node != nullptr) { // If the subtree is not empty, delete its children first.
+		deleteTree(node->left); // Delete the left subtree.
+		deleteTree(node->right); // Delete the right subtree.
+		delete[] node->text; // Delete the characters of the key. In the current version, every key belongs to exactly one node.
+		delete node; // Delete the node.
+	}
+}
@@ -0,0 +1,86 @@
+/*
+This header file defines a Binary Search Tree (BST) that many threads can use at the same time. Published nodes are never changed: a writer copies the
+nodes on the path it changes, builds the new version of that path next to the old one, and swaps the root to the new version with a single compare-and-swap.
+If another writer got there first, the writer throws its copies away and tries again on the newer tree. Readers therefore never take a lock and always
+see a complete tree, and the nodes a writer replaced are handed to an epoch-based reclaimer, which deletes them once no reader can still be looking at
+them. The tree keeps itself balanced with the AVL rules, so a writer copies O(log n) nodes.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <atomic> // This is a header file library that lets us work with values that are safe to share between threads.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <string> // This is a header file library that lets us work with strings.
+#include <string_view> // This is a header file library that lets us refer to characters without copying them.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+#include "KeyPool.h" // This is a header file that contains the search key and the prefix function shared with the other trees.
+#include "EpochReclaimer.h" // This is a header file that contains the reclaimer that deletes replaced nodes safely.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+struct ConcurrentNode { // This struct represents a node of the concurrent tree. Once it is reachable from the root, it never changes.
+	uint64_t prefix; // This number stores the first eight bytes of the key, packed so that comparing numbers compares the bytes.
+	const char* text; // This pointer points to the characters of the key. Copies of a node share them.
+	uint32_t length; // This number stores the length of the key.
+	int16_t height; // This number stores the height of the subtree rooted at this node.
+	bool fresh; // This flag is set while the node belongs to an update that has not been published, so the writer can still change it.
+	ConcurrentNode* left; // This pointer points to the left child of the node.
+	ConcurrentNode* right; // This pointer points to the right child of the node.
+};
+
+class ConcurrentBinarySearchTree { // This class represents a balanced binary search tree with lock-free lookups and compare-and-swap updates.
+private: // This section contains private members of the class.
+	struct Update { // This struct collects the nodes one attempt at an update created and replaced.
+		vector<ConcurrentNode*> created; // This vector stores the nodes the attempt created.
+		vector<ConcurrentNode*> replaced; // This vector stores the published nodes the attempt replaced.
+		const char* removedText = nullptr; // This pointer points to the characters of the key the attempt removed, if any.
+	};
+
+	atomic<ConcurrentNode*> root; // This pointer points to the root of the current version of the tree.
+	atomic<size_t> nodeCount; // This number stores the number of keys in the tree.
+	mutable EpochReclaimer reclaimer; // This reclaimer deletes the replaced nodes once no reader can still see them.
+
+	int compareKey(const SearchKey& key, const ConcurrentNode* node) const; // This function compares the search key with the key of the node and returns a negative, zero or positive number.
+	static int nodeHeight(const ConcurrentNode* node); // This function returns the height of the subtree rooted at the given node, or 0 for an empty subtree.
+	static void updateHeight(ConcurrentNode* node); // This function recalculates the height of the node from the heights of its children.
+	static ConcurrentNode* writable(ConcurrentNode* node, Update& update); // This function returns a node the update may change: the node itself if the update created it, otherwise a copy.
+	static ConcurrentNode* rebalance(ConcurrentNode* node, Update& update); // This function restores the AVL balance of a node the update may change.
+	static ConcurrentNode* rotateLeft(ConcurrentNode* node, Update& update); // This function rotates the subtree rooted at the node to the left.
+	static ConcurrentNode* rotateRight(ConcurrentNode* node, Update& update); // This function rotates the subtree rooted at the node to the right.
+	ConcurrentNode* insertRecursive(ConcurrentNode* node, const SearchKey& key, const char* text, Update& update) const; // This function returns the new version of the subtree with the key inserted, or the same subtree if the key is already in it.
+	ConcurrentNode* removeRecursive(ConcurrentNode* node, const SearchKey& key, Update& update) const; // This function returns the new version of the subtree with the key removed, or the same subtree if the key is not in it.
+	static ConcurrentNode* removeMin(ConcurrentNode* node, ConcurrentNode*& minimum, Update& update); // This function returns the new version of the subtree without its smallest node, and stores that node in minimum.
+	bool publish(ConcurrentNode* expected, ConcurrentNode* desired, Update& update); // This function swaps the root to the new version if it is still the expected one, and cleans up after the attempt either way.
+	static void deleteTree(ConcurrentNode* node); // This function deletes the nodes and the keys of the given subtree.
+
+public: // This section contains public members of the class.
+	ConcurrentBinarySearchTree(); // This is the default constructor for an empty tree.
+	ConcurrentBinarySearchTree(const ConcurrentBinarySearchTree&) = delete; // The tree is shared between threads by reference, so it cannot be copied.
+	ConcurrentBinarySearchTree& operator=(const ConcurrentBinarySearchTree&) = delete; // The tree is shared between threads by reference, so it cannot be copy-assigned.
+	~ConcurrentBinarySearchTree(); // This is the destructor. No other thread may use the tree when it runs.
+
+	bool insert(string_view word); // This function inserts the word. It returns false if the word was already in the tree.
+	bool remove(string_view word); // This function removes the word. It returns false if the word was not in the tree.
+	bool exists(string_view word) const; // This function checks if the word is in the tree, without taking a lock.
+	string inorder() const; // This function returns the keys of one version of the tree in sorted order, separated by spaces, without taking a lock.
+	int height() const; // This function returns the height of the current version of the tree.
+	size_t size() const; // This function returns the number of keys in the tree. While writers are running, it may be slightly behind.
+	size_t pendingReclaim() const; // This function returns the number of replaced nodes and keys that have not been deleted yet.
+	void reclaim(); // This function deletes the replaced nodes and keys that no reader can still see. Called while no thread is using the tree, it deletes all of them.
+
+	template <typename Visitor>
+	void forEach(Visitor visit) const { // This function calls visit with every key of one version of the tree in sorted order, without taking a lock.
+		EpochReclaimer::Guard guard(reclaimer); // Keep the nodes of the version alive until the walk is done.
+		vector<const ConcurrentNode*> stack; // Create a stack to store the nodes whose left subtree is being visited.
+		const ConcurrentNode* node = root.load(memory_order_acquire); // Start at the root of the current version.
+		while (node != nullptr || !stack.empty()) { // Loop until every node has been visited.
+			while (node != nullptr) { // Walk down to the leftmost node that has not been visited.
+				stack.push_back(node); // Remember the node.
+				node = node->left; // Move to the left child.
+			}
+			node = stack.back(); // Take the next node in sorted order.
+			stack.pop_back(); // Remove it from the stack.
+			visit(string_view(node->text, node->length)); // Visit the key.
+			node = node->right; // Continue with the right subtree.
+		}
+	}
+};
@@ -0,0 +1,174 @@
+/*
+This implementation file provides the implementations for the epoch-based reclaimer declared in the header file. It gives every thread a slot the
+first time it reads, and frees the slot again when the thread ends, so a later thread can take it over. Slot numbers are handed out from a list of
+blocks shared by all reclaimers, and every reclaimer keeps its slots in a matching list of blocks, so both grow when more threads read at once.
+*/
+
+#include "EpochReclaimer.h" // This is a header file that contains the declaration of the epoch-based reclaimer.
+
+struct ClaimBlock { // This struct stores which slots of one block belong to a running thread, and links to the next block.
+	atomic<bool> taken[EpochReclaimer::slotsPerBlock] = {}; // This array stores a flag for every slot of the block.
+	atomic<ClaimBlock*> next{ nullptr }; // This pointer points to the next block, or is null until more threads run at once.
+};
+
+static ClaimBlock firstClaims; // This block stores which of the first slots are taken. Later blocks are never freed, because their slot numbers can be taken again.
+static atomic<size_t> slotLimit{ 0 }; // This number stores one past the highest slot that was ever taken, so the epoch check skips unused slots.
+
+struct ThreadSlot { // This struct claims a slot for the current thread and gives it back when the thread ends.
+	size_t index; // This number stores the slot of the thread.
+	atomic<bool>* taken; // This pointer points to the flag that marks the slot as taken.
+
+	ThreadSlot() { // This is the constructor, which claims the first free slot, adding a block if every slot is taken.
+		ClaimBlock* block = &firstClaims; // Start at the first block.
+		for (size_t base = 0; ; base += EpochReclaimer::slotsPerBlock) { // Loop through the blocks until a slot is free.
+			for (size_t i = 0; i < EpochReclaimer::slotsPerBlock; ++i) { // Loop through the slots of the block.
+				if (!block->taken[i].exchange(true, memory_order_acq_rel)) { // If the slot was free, it now belongs to this thread.
+					index = base + i; // Store the number of the slot.
+					taken = &block->taken[i]; // Remember the flag, so the slot can be given back.
+					size_t limit = slotLimit.load(); // Get the current limit.
+					while (limit <= index && !slotLimit.compare_exchange_weak(limit, index + 1)) {} // Raise the limit, so the epoch check includes the slot.
+					return; // Return with the claimed slot.
+				}
+			}
+			ClaimBlock* next = block->next.load(); // Get the next block.
+			if (next == nullptr) { // If there is none, every slot is taken, so add a block.
+				ClaimBlock* added = new ClaimBlock(); // Create an empty block.
+				if (block->next.compare_exchange_strong(next, added)) { // Link it, unless another thread added a block first.
+					next = added; // Continue in the new block.
+				}
+				else { // Otherwise, the other thread's block is used and this one is not needed.
+					delete added; // Free the unused block.
+				}
+			}
+			block = next; // Move to the next block.
+		}
+	}
+
+	~ThreadSlot() { // This is the destructor, which gives the slot back.
+		taken->store(false, memory_order_release); // Free the slot. Its retired objects stay in the reclaimer, where the next collection by any thread deletes them.
+	}
+};
+
+EpochReclaimer::EpochReclaimer() : globalEpoch(1) {} // This is the default constructor for a reclaimer with nothing to delete. Epoch 0 means "not reading", so counting starts at 1.
+
+EpochReclaimer::~EpochReclaimer() { // This is the destructor, which deletes every retired object. No thread may be reading when it runs.
+	forEachSlot([](Slot& slot) { // Loop through the slots.
+		for (const Retired& retired : slot.retired) { // Loop through the retired objects.
+			retired.destroy(retired.object); // Delete the object.
+		}
+		return true; // Continue with the next slot.
+	});
+	for (SlotBlock* block = firstBlock.next.load(); block != nullptr; ) { // Loop through the blocks that were added.
+		SlotBlock* next = block->next.load(); // Remember the next block.
+		delete block; // Free the block.
+		block = next; // Move to the next block.
+	}
+}
+
+size_t EpochReclaimer::threadIndex() { // This function returns the slot of the current thread, claiming one the first time it is called.
+	thread_local ThreadSlot slot; // Claim a slot the first time the thread gets here. It is given back when the thread ends.
+	return slot.index; // Return the slot.
+}
+
+size_t EpochReclaimer::usedSlots() { // This function returns one past the highest slot that was ever taken, so scans skip unused slots.
+	return slotLimit.load(); // Return the limit.
+}
+
+EpochReclaimer::Slot& EpochReclaimer::slotAt(size_t index) { // This function returns the slot with the given index, adding blocks until it exists.
+	SlotBlock* block = &firstBlock; // Start at the first block.
+	for (; index >= slotsPerBlock; index -= slotsPerBlock) { // Walk one block for every full block before the slot. The first block covers most programs, so this loop rarely runs.
+		SlotBlock* next = block->next.load(); // Get the next block.
+		if (next == nullptr) { // If the block was never needed in this reclaimer, add it.
+			SlotBlock* added = new SlotBlock(); // Create a block of free slots.
+			if (block->next.compare_exchange_strong(next, added)) { // Link it, unless another thread added a block first.
+				next = added; // Continue in the new block.
+			}
+			else { // Otherwise, the other thread's block is used and this one is not needed.
+				delete added; // Free the unused block.
+			}
+		}
+		block = next; // Move to the next block.
+	}
+	return block->slots[index]; // Return the slot.
+}
+
+void EpochReclaimer::enter() { // This function marks the current thread as a reader. Calls can be nested.
+	Slot& slot = slotAt(threadIndex()); // Get the slot of the thread.
+	if (slot.depth++ == 0) { // Only the outermost guard announces an epoch.
+		slot.epoch.store(globalEpoch.load(memory_order_relaxed), memory_order_relaxed); // Announce the current epoch.
+		atomic_thread_fence(memory_order_seq_cst); // Order the announcement before every pointer the reader loads. Either tryAdvance sees the announcement and waits
+		// for the reader, or the reader's loads come after tryAdvance's scan and see every unlink that happened before it. An object retired in epoch e was
+		// unlinked before the epoch reached e + 1, and the epoch only reaches e + 2 once every reader announced e + 1, after that unlink, so no reader that
+		// can still find the object is left when it is deleted.
+	}
+}
+
+void EpochReclaimer::exit() { // This function ends the read that the matching enter started.
+	Slot& slot = slotAt(threadIndex()); // Get the slot of the thread.
+	if (--slot.depth == 0) { // Only the outermost guard stops reading.
+		slot.epoch.store(0, memory_order_release); // Announce that the thread is not reading, after all of its loads.
+	}
+}
+
+void EpochReclaimer::retire(void* object, void (*destroy)(void*)) { // This function deletes the object with the given function once no reader can still see it.
+	Slot& slot = slotAt(threadIndex()); // Get the slot of the thread.
+	size_t waiting; // Create a variable to store the number of objects the thread has waiting.
+	{
+		lock_guard<mutex> guard(slot.lock); // Lock the slot, in case another thread is collecting it.
+		slot.retired.push_back({ object, destroy, globalEpoch.load() }); // Remember the object and the epoch in which it was unlinked.
+		waiting = slot.retired.size(); // Count the objects that are waiting.
+	}
+	if (waiting >= collectThreshold) { // If enough objects are waiting, delete the ones no reader can still see.
+		collect(); // Collect the objects of every thread.
+	}
+}
+
+void EpochReclaimer::collect() { // This function moves the epoch forward as far as the readers allow and deletes the objects of every thread that no reader can still see.
+	for (int step = 0; step < 2 && tryAdvance(); ++step) {} // Two steps expire everything retired before the call, unless a reader holds the epoch back.
+	uint64_t current = globalEpoch.load(); // Get the current epoch.
+	forEachSlot([current](Slot& slot) { // Loop through the slots, including the slots of threads that have ended.
+		freeExpired(slot, current); // Delete the objects of the slot that no reader can still see.
+		return true; // Continue with the next slot.
+	});
+}
+
+bool EpochReclaimer::tryAdvance() { // This function moves the global epoch forward if every reader has caught up with it, and returns whether it moved.
+	uint64_t current = globalEpoch.load(); // Get the current epoch.
+	bool caughtUp = true; // Create a flag to store whether every reader is in the current epoch.
+	forEachSlot([current, &caughtUp](Slot& slot) { // Loop through the slots.
+		uint64_t epoch = slot.epoch.load(); // Get the epoch the thread is reading in.
+		caughtUp = epoch == 0 || epoch == current; // A reader that is still in an older epoch holds the epoch back.
+		return caughtUp; // Stop at the first such reader.
+	});
+	if (!caughtUp) { // If a reader is behind, the epoch cannot move yet.
+		return false; // Return without moving the epoch.
+	}
+	globalEpoch.compare_exchange_strong(current, current + 1); // Move the epoch forward, unless another thread already did.
+	return true; // Either way, the epoch has moved.
+}
+
+void EpochReclaimer::freeExpired(Slot& slot, uint64_t current) { // This function deletes the objects of the slot that were retired at least two epochs before the given one.
+	vector<Retired> expired; // Create a vector to store the objects that can be deleted, so they are deleted after the slot is unlocked.
+	{
+		lock_guard<mutex> guard(slot.lock); // Lock the slot, so its owner does not add objects while they are moved.
+		size_t count = 0; // Create a counter for the objects that can be deleted.
+		while (count < slot.retired.size() && slot.retired[count].epoch + 2 <= current) { // The objects are in retire order, so the old ones are at the front.
+			++count; // Count the object.
+		}
+		expired.assign(slot.retired.begin(), slot.retired.begin() + count); // Take the expired objects.
+		slot.retired.erase(slot.retired.begin(), slot.retired.begin() + count); // Forget them in the slot.
+	}
+	for (const Retired& retired : expired) { // Loop through the expired objects.
+		retired.destroy(retired.object); // Delete the object.
+	}
+}
+
+size_t EpochReclaimer::pendingCount() const { // This function returns the number of retired objects that have not been deleted yet. It is only exact when no thread is working.
+	size_t count = 0; // Create a counter for the retired objects.
+	forEachSlot([&count](Slot& slot) { // Loop through the slots.
+		lock_guard<mutex> guard(slot.lock); // Lock the slot, so its owner does not change the objects while they are counted.
+		count += slot.retired.size(); // Count the objects of the slot.
+		return true; // Continue with the next slot.
+	});
+	return count; // Return the number of retired objects.
+}
@@ -0,0 +1,96 @@
+/*
+This header file defines an epoch-based reclaimer. Lock-free readers cannot tell a writer when they are done with a node, so a writer that unlinks a
+node hands it to the reclaimer instead of deleting it. Every reader announces the global epoch it started in, the global epoch only moves forward once
+every active reader has caught up with it, and an object retired in epoch e is deleted once the global epoch reaches e + 2, because by then every
+reader that could still have seen the object has finished. Any thread can collect the retired objects of every thread, so objects retired by a thread
+that has ended are freed by the next collection instead of waiting for the slot to be reused. The slots are kept in blocks that are added when more
+threads read at once than the blocks so far can hold, so there is no limit on the number of threads and a lookup never fails.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <atomic> // This is a header file library that lets us work with values that are safe to share between threads.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <mutex> // This is a header file library that lets us protect shared data with a lock.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+class EpochReclaimer { // This class delays deleting objects until no reader can still be looking at them.
+public: // This section contains public members of the class.
+	static constexpr size_t slotsPerBlock = 64; // This is the number of thread slots in one block. More blocks are added when more threads read at once.
+
+	class Guard { // This class marks the current thread as a reader for as long as it exists.
+	private: // This section contains private members of the class.
+		EpochReclaimer& reclaimer; // This reference stores the reclaimer the thread reads from.
+
+	public: // This section contains public members of the class.
+		explicit Guard(EpochReclaimer& reclaimer) : reclaimer(reclaimer) { // This is the constructor, which enters the current epoch.
+			reclaimer.enter(); // Announce that the thread is reading.
+		}
+		Guard(const Guard&) = delete; // A guard belongs to one scope, so it cannot be copied.
+		Guard& operator=(const Guard&) = delete; // A guard belongs to one scope, so it cannot be copy-assigned.
+		~Guard() { // This is the destructor, which leaves the epoch.
+			reclaimer.exit(); // Announce that the thread has stopped reading.
+		}
+	};
+
+	EpochReclaimer(); // This is the default constructor for a reclaimer with nothing to delete.
+	EpochReclaimer(const EpochReclaimer&) = delete; // The reclaimer owns the retired objects, so it cannot be copied.
+	EpochReclaimer& operator=(const EpochReclaimer&) = delete; // The reclaimer owns the retired objects, so it cannot be copy-assigned.
+	~EpochReclaimer(); // This is the destructor, which deletes every retired object. No thread may be reading when it runs.
+
+	void enter(); // This function marks the current thread as a reader. Calls can be nested.
+	void exit(); // This function ends the read that the matching enter started.
+	void retire(void* object, void (*destroy)(void*)); // This function deletes the object with the given function once no reader can still see it.
+	void collect(); // This function moves the epoch forward as far as the readers allow and deletes the objects of every thread that no reader can still see. Called while no thread is reading, it deletes everything.
+	size_t pendingCount() const; // This function returns the number of retired objects that have not been deleted yet. It is only exact when no thread is working.
+
+	template <typename T>
+	void retire(T* object) { // This function deletes the object with delete once no reader can still see it.
+		retire(object, [](void* pointer) { delete static_cast<T*>(pointer); }); // Retire the object with a function that deletes it as a T.
+	}
+
+private: // This section contains private members of the class.
+	struct Retired { // This struct stores an object that is waiting to be deleted.
+		void* object; // This pointer points to the object.
+		void (*destroy)(void*); // This function deletes the object.
+		uint64_t epoch; // This number stores the global epoch in which the object was retired.
+	};
+
+	struct alignas(64) Slot { // This struct stores the state of one thread. It fills a cache line, so threads never write to the same line.
+		atomic<uint64_t> epoch{ 0 }; // This number stores the epoch the thread is reading in, or 0 if it is not reading.
+		unsigned depth = 0; // This number stores how many guards of the thread are open. Only the owning thread uses it.
+		mutex lock; // This mutex protects the retired objects, so any thread can delete them. Only collections compete with the owner for it.
+		vector<Retired> retired; // This vector stores the objects the thread retired, oldest first.
+	};
+
+	struct SlotBlock { // This struct stores a block of slots and links to the next block, so the table can grow while readers scan it.
+		Slot slots[slotsPerBlock]; // This array stores the state of the threads whose slots fall into the block.
+		atomic<SlotBlock*> next{ nullptr }; // This pointer points to the next block, or is null until a thread needs it.
+	};
+
+	static constexpr size_t collectThreshold = 128; // This is the number of retired objects after which a thread collects.
+
+	atomic<uint64_t> globalEpoch; // This number stores the current global epoch.
+	mutable SlotBlock firstBlock; // This block stores the slots of the first threads. Counting the retired objects locks the slots, so it is mutable.
+
+	static size_t threadIndex(); // This function returns the slot of the current thread, claiming one the first time it is called.
+	Slot& slotAt(size_t index); // This function returns the slot with the given index, adding blocks until it exists.
+	template <typename Visit>
+	void forEachSlot(Visit visit) const { // This function calls visit with every slot that was ever taken, in index order, and stops early if visit returns false.
+		size_t limit = usedSlots(); // Get the number of slots that were ever used.
+		SlotBlock* block = &firstBlock; // Start at the first block. It is mutable, so a const scan can still lock the slots.
+		for (size_t base = 0; block != nullptr && base < limit; base += slotsPerBlock) { // Loop through the blocks that hold used slots. A block that was never added holds no reader.
+			for (size_t i = 0; i < slotsPerBlock && base + i < limit; ++i) { // Loop through the used slots of the block.
+				if (!visit(block->slots[i])) { // Visit the slot.
+					return; // Stop if visit asked to.
+				}
+			}
+			block = block->next.load(); // Move to the next block.
+		}
+	}
+	static size_t usedSlots(); // This function returns one past the highest slot that was ever taken, so scans skip unused slots.
+	bool tryAdvance(); // This function moves the global epoch forward if every reader has caught up with it, and returns whether it moved.
+	static void freeExpired(Slot& slot, uint64_t current); // This function deletes the objects of the slot that were retired at least two epochs before the given one.
+};
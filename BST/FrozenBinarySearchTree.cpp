@@ -0,0 +1,198 @@
+/*
+This implementation file provides the implementations for the read-only snapshot declared in the header file. It defines how a sorted list of keys is
+laid out in Eytzinger order and how a lookup walks that layout. Each step computes the next index from the comparison of the cached prefixes without a
+branch; only keys that share their first eight bytes take a branch to compare the rest of their characters.
+*/
+
+#include "FrozenBinarySearchTree.h" // This is a header file that contains the declaration of the read-only snapshot.
+#include <algorithm> // This is a header file library that lets us use algorithms such as min.
+#include <cstring> // This is a header file library that lets us compare raw memory with memcmp.
+#include <stdexcept> // This is a header file library that lets us report errors with exceptions.
+#include <fstream> // This is a header file library that lets us work with files.
+#include <filesystem> // This is a header file library that lets us rename and remove files.
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> // This is a header file library that lets us use the prefetch instruction with the Microsoft compiler.
+#define BST_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0) // This macro asks the processor to load the given address into the cache.
+#elif defined(__GNUC__)
+#define BST_PREFETCH(address) __builtin_prefetch(address) // This macro asks the processor to load the given address into the cache.
+#else
+#define BST_PREFETCH(address) ((void)(address)) // This macro does nothing on compilers without a prefetch instruction.
+#endif
+
+static const uint64_t lengthBits = 24; // This is the number of bits of an entry's location that store the key length.
+static const uint64_t lengthMask = (uint64_t(1) << lengthBits) - 1; // This mask selects the key length from an entry's location.
+static const uint64_t fileMagic = 0x31305A5246545342; // This number spells "BSTFRZ01" when written by a little-endian machine, so a file from another byte order is rejected.
+
+static unsigned countTrailingOnes(uint64_t value) { // This function counts how many of the lowest bits of the value are set.
+#if defined(__GNUC__)
+	return static_cast<unsigned>(__builtin_ctzll(~value)); // Count the trailing zeros of the inverted value with a single instruction.
+#else
+	unsigned count = 0; // Create a counter for the number of set bits.
+	while (value & 1) { // Loop while the lowest bit is set.
+		value >>= 1; // Move to the next bit.
+		++count; // Count the set bit.
+	}
+	return count; // Return the number of set bits.
+#endif
+}
+
+FrozenBinarySearchTree::FrozenBinarySearchTree() : entryStorage(1), entries(entryStorage.data()), count(0), keys(nullptr), keyBytes(0) {} // This is the default constructor for an empty snapshot.
+
+FrozenBinarySearchTree::FrozenBinarySearchTree(const vector<string_view>& sortedKeys) : entryStorage(sortedKeys.size() + 1), entries(entryStorage.data()), count(sortedKeys.size()), keys(nullptr), keyBytes(0) { // This is a constructor that builds a snapshot from keys that are sorted and unique.
+	size_t totalLength = 0; // Create a counter for the number of key characters.
+	for (string_view key : sortedKeys) { // Loop through the keys.
+		if (key.size() > lengthMask) { // The length has to fit in the lower bits of the location.
+			throw length_error("FrozenBinarySearchTree: key is longer than 16 MiB"); // Report that the key is too long.
+		}
+		totalLength += key.size(); // Count the characters of the key.
+	}
+	keyStorage.reserve(totalLength); // Make room for all characters, so the vector never has to grow.
+	size_t next = 0; // Create an index for the next sorted key to place.
+	fillEytzinger(sortedKeys, next, 1); // Place the keys, starting at the root.
+	keys = keyStorage.data(); // Point to the key characters.
+	keyBytes = keyStorage.size(); // Store the number of key characters.
+}
+
+void FrozenBinarySearchTree::fillEytzinger(const vector<string_view>& sortedKeys, size_t& next, size_t index) { // This function places the sorted keys at their Eytzinger positions.
+	if (index > count) { // If the index is past the last entry, there is nothing to place.
+		return; // Return without placing a key.
+	}
+	fillEytzinger(sortedKeys, next, 2 * index); // Place the smaller keys in the left subtree first.
+	string_view key = sortedKeys[next++]; // Take the next key in sorted order.
+	entryStorage[index] = FrozenEntry{ KeyPool::prefixOf(key), (uint64_t(keyStorage.size()) << lengthBits) | key.size() }; // Store the prefix, offset and length of the key.
+	keyStorage.insert(keyStorage.end(), key.begin(), key.end()); // Copy the characters of the key.
+	fillEytzinger(sortedKeys, next, 2 * index + 1); // Place the larger keys in the right subtree.
+}
+
+int FrozenBinarySearchTree::compareEntry(const SearchKey& key, const FrozenEntry& entry) const { // This function compares the given key with the key of the entry and returns a negative, zero or positive number.
+	if (key.prefix != entry.prefix) { // If the first eight bytes differ, the prefixes alone decide the order.
+		return key.prefix < entry.prefix ? -1 : 1; // Return the order of the prefixes.
+	}
+	string_view other = keyOf(entry); // Get the characters of the entry.
+	size_t common = min(key.text.size(), other.size()); // Calculate the number of characters both keys have.
+	if (common > 8) { // If both keys are longer than the prefix, compare the rest of the characters.
+		int result = memcmp(key.text.data() + 8, other.data() + 8, common - 8); // Compare the characters after the prefix.
+		if (result != 0) { // If the characters differ, they decide the order.
+			return result; // Return the order of the characters.
+		}
+	}
+	if (key.text.size() == other.size()) { // If all shared characters are equal and the keys have the same length, the keys are equal.
+		return 0; // Return 0 to indicate that the keys are equal.
+	}
+	return key.text.size() < other.size() ? -1 : 1; // Otherwise, the shorter key comes first.
+}
+
+string_view FrozenBinarySearchTree::keyOf(const FrozenEntry& entry) const { // This function returns the key of the given entry.
+	return string_view(keys + (entry.location >> lengthBits), entry.location & lengthMask); // Return a view of the characters of the key.
+}
+
+bool FrozenBinarySearchTree::exists(string_view word) const { // This function checks if the given word is in the snapshot.
+	SearchKey key = KeyPool::makeSearchKey(word); // Create a search key for the word, so its prefix is only computed once.
+	const FrozenEntry* data = entries; // Get a pointer to the entries.
+	size_t index = 1; // Start at the root.
+	while (index <= count) { // Walk down until the index falls off the bottom of the tree.
+		BST_PREFETCH(data + 8 * index); // Prefetch the first half of the entries three levels below.
+		BST_PREFETCH(data + 8 * index + 4); // Prefetch the second half of the entries three levels below.
+		const FrozenEntry& entry = data[index]; // Get the current entry.
+		size_t larger = key.prefix > entry.prefix; // Compare the prefixes, which decide almost every step, into a flag instead of a branch.
+		if (key.prefix == entry.prefix) { // Only a key that shares the first eight bytes needs its characters compared. This branch is rarely taken, so it is well predicted.
+			larger = compareEntry(key, entry) > 0; // Compare the whole keys.
+		}
+		index = 2 * index + larger; // Go to the right child if the key is larger, otherwise to the left child.
+	}
+	index >>= countTrailingOnes(index) + 1; // Undo the right turns taken after the last left turn, which leads to the smallest entry that is not less than the key.
+	return index != 0 && compareEntry(key, data[index]) == 0; // The word exists if that entry is equal to it.
+}
+
+size_t FrozenBinarySearchTree::size() const { // This function returns the number of keys in the snapshot.
+	return count; // Return the number of keys.
+}
+
+size_t FrozenBinarySearchTree::memoryBytes() const { // This function returns the number of bytes used by the entries and the key characters.
+	return (count + 1) * sizeof(FrozenEntry) + keyBytes; // Add the size of the entries and of the characters.
+}
+
+vector<string_view> FrozenBinarySearchTree::sortedKeys() const { // This function returns the keys of the snapshot in sorted order.
+	vector<string_view> sorted; // Create a vector to store the keys.
+	sorted.reserve(count); // Make room for all keys.
+	if (count == 0) { // If the snapshot is empty, there is nothing to return.
+		return sorted; // Return the empty vector.
+	}
+	size_t index = 1; // Start at the root.
+	while (2 * index <= count) { // Walk down to the leftmost entry, which holds the smallest key.
+		index = 2 * index; // Move to the left child.
+	}
+	while (index != 0) { // Visit the entries in sorted order until the walk climbs above the root.
+		sorted.push_back(keyOf(entries[index])); // Add the key of the entry.
+		if (2 * index + 1 <= count) { // If the entry has a right subtree, its smallest key comes next.
+			index = 2 * index + 1; // Move to the right child.
+			while (2 * index <= count) { // Walk down to the leftmost entry of that subtree.
+				index = 2 * index; // Move to the left child.
+			}
+		}
+		else { // Otherwise, climb up until the walk comes from a left child.
+			index >>= countTrailingOnes(index) + 1; // Undo the right turns and the left turn before them, which leads to the next larger key.
+		}
+	}
+	return sorted; // Return the keys.
+}
+
+bool FrozenBinarySearchTree::save(const string& filename) const { // This function writes the snapshot to a file in the layout open expects. It returns false if the file cannot be written.
+	string temporary = filename + ".tmp"; // Write to a temporary file first. Truncating a file that is mapped somewhere would break the mapping.
+	{
+		ofstream file(temporary, ios::binary | ios::trunc); // Open the temporary file for writing, without any newline translation.
+		if (!file.is_open()) { // If the file cannot be opened, report it to the caller.
+			return false; // Return false to indicate that the file could not be written.
+		}
+		FrozenFileHeader header{ fileMagic, count, keyBytes, 0 }; // Create the header of the file.
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header)); // Write the header.
+		file.write(reinterpret_cast<const char*>(entries), static_cast<streamsize>((count + 1) * sizeof(FrozenEntry))); // Write the entries, including the unused one, so they can be used in place.
+		file.write(keys, static_cast<streamsize>(keyBytes)); // Write the key characters.
+		file.close(); // Flush the characters to the file.
+		if (!file) { // If any write failed, the temporary file is incomplete.
+			error_code ignored; // Create a variable to store the error of the cleanup, which does not matter here.
+			filesystem::remove(temporary, ignored); // Delete the incomplete file.
+			return false; // Return false to indicate that the file could not be written.
+		}
+	}
+	error_code error; // Create a variable to store the error of the rename, so it does not throw.
+	filesystem::rename(temporary, filename, error); // Replace the file in one step. On POSIX systems, a snapshot that still maps the old file keeps reading the old characters.
+	// Windows does not delete a file while a view of it is mapped, so there the rename fails, and the save returns false, until every snapshot of the file is closed.
+	if (error) { // If the file cannot be replaced, report it to the caller.
+		filesystem::remove(temporary, error); // Delete the temporary file.
+		return false; // Return false to indicate that the file could not be written.
+	}
+	return true; // Return true to indicate that the snapshot was saved.
+}
+
+bool FrozenBinarySearchTree::open(const string& filename) { // This function maps a saved snapshot and queries it in place. It returns false if the file cannot be mapped or is not a snapshot.
+	unique_ptr<MappedFile> file(new MappedFile()); // Create the mapped file.
+	if (!file->open(filename)) { // If the file cannot be mapped, report it to the caller.
+		return false; // Return false to indicate that the file could not be opened.
+	}
+	string_view contents = file->contents(); // Get the characters of the file.
+	FrozenFileHeader header; // Create a variable to store the header of the file.
+	if (contents.size() < sizeof(header)) { // If the file is too small to hold a header, it is not a snapshot.
+		return false; // Return false to indicate that the file is not a snapshot.
+	}
+	memcpy(&header, contents.data(), sizeof(header)); // Copy the header out of the file.
+	if (header.magic != fileMagic || header.count >= contents.size() / sizeof(FrozenEntry) || header.keyBytes > contents.size() || contents.size() != sizeof(header) + (header.count + 1) * sizeof(FrozenEntry) + header.keyBytes) { // If the header does not describe this file, it is not a snapshot.
+		return false; // Return false to indicate that the file is not a snapshot.
+	}
+	const FrozenEntry* fileEntries = reinterpret_cast<const FrozenEntry*>(contents.data() + sizeof(header)); // Point to the entries inside the mapped file. The mapping starts on a page boundary, so they are aligned.
+	for (size_t index = 1; index <= header.count; ++index) { // Loop through the entries, so a damaged file is rejected here instead of being read past its end later.
+		uint64_t location = fileEntries[index].location; // Get where the key starts and how long it is.
+		if ((location >> lengthBits) + (location & lengthMask) > header.keyBytes) { // If the key would end after the key characters, the file is damaged. The sum cannot overflow, because both parts are smaller than 2^40.
+			return false; // Return false to indicate that the file is not a valid snapshot.
+		}
+	}
+	entryStorage.clear(); // Release any entries that were built in memory.
+	keyStorage.clear(); // Release any key characters that were built in memory.
+	entries = fileEntries; // Use the entries inside the mapped file.
+	count = static_cast<size_t>(header.count); // Store the number of keys.
+	keys = contents.data() + sizeof(header) + (count + 1) * sizeof(FrozenEntry); // Point to the key characters inside the mapped file.
+	keyBytes = static_cast<size_t>(header.keyBytes); // Store the number of key characters.
+	mapping = move(file); // Keep the file mapped for as long as the snapshot uses it.
+	return true; // Return true to indicate that the snapshot was opened.
+}
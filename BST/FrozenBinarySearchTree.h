@@ -0,0 +1,61 @@
+/*
+This header file defines a read-only snapshot of a Binary Search Tree (BST). The snapshot stores the keys in one contiguous array in Eytzinger order,
+which is the order a breadth-first walk of a perfectly balanced tree would visit them, so the children of the entry at index k are found at 2k and 2k+1.
+A lookup therefore never follows a pointer, the first levels of the tree share a few cache lines, and the next levels can be prefetched while the
+current comparison is still running. A snapshot can be saved to a file in the same layout and mapped back into memory, so it can be queried right away
+without parsing or rebuilding anything.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <memory> // This is a header file library that lets us own objects through smart pointers, such as unique_ptr.
+#include <string> // This is a header file library that lets us work with strings.
+#include <string_view> // This is a header file library that lets us refer to characters without copying them.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+#include "KeyPool.h" // This is a header file that contains the search key and the prefix function shared with the tree.
+#include "MappedFile.h" // This is a header file that contains the memory-mapped file a saved snapshot is opened with.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+struct FrozenEntry { // This struct represents one key of the snapshot. It is 16 bytes, so four entries fit in a cache line.
+	uint64_t prefix; // This number stores the first eight bytes of the key, so most comparisons never read the key characters.
+	uint64_t location; // This number stores where the key starts in the key characters (upper 40 bits) and its length (lower 24 bits).
+};
+
+struct FrozenFileHeader { // This struct represents the start of a saved snapshot. The entries follow it directly, and the key characters follow the entries.
+	uint64_t magic; // This number identifies the file format and the byte order of the machine that wrote it.
+	uint64_t count; // This number stores how many keys the snapshot holds.
+	uint64_t keyBytes; // This number stores how many key characters follow the entries.
+	uint64_t reserved; // This number is unused and keeps the entries aligned to 16 bytes.
+};
+
+class FrozenBinarySearchTree { // This class represents an immutable, contiguous copy of a binary search tree that is optimized for lookups.
+private: // This section contains private members of the class.
+	vector<FrozenEntry> entryStorage; // This vector owns the entries when the snapshot was built in memory.
+	vector<char> keyStorage; // This vector owns the key characters when the snapshot was built in memory.
+	unique_ptr<MappedFile> mapping; // This pointer owns the mapped file when the snapshot was opened from a file.
+	const FrozenEntry* entries; // This pointer points to the keys in Eytzinger order. Index 0 is unused, so the root is at index 1.
+	size_t count; // This number stores how many keys the snapshot holds.
+	const char* keys; // This pointer points to the characters of all keys, one after another in sorted order.
+	size_t keyBytes; // This number stores how many key characters the snapshot holds.
+
+	void fillEytzinger(const vector<string_view>& sortedKeys, size_t& next, size_t index); // This function places the sorted keys at their Eytzinger positions.
+	int compareEntry(const SearchKey& key, const FrozenEntry& entry) const; // This function compares the given key with the key of the entry and returns a negative, zero or positive number.
+	string_view keyOf(const FrozenEntry& entry) const; // This function returns the key of the given entry.
+
+public: // This section contains public members of the class.
+	FrozenBinarySearchTree(); // This is the default constructor for an empty snapshot.
+	explicit FrozenBinarySearchTree(const vector<string_view>& sortedKeys); // This is a constructor that builds a snapshot from keys that are sorted and unique.
+	FrozenBinarySearchTree(const FrozenBinarySearchTree&) = delete; // The snapshot may refer to a mapped file, so it cannot be copied.
+	FrozenBinarySearchTree& operator=(const FrozenBinarySearchTree&) = delete; // The snapshot may refer to a mapped file, so it cannot be copy-assigned.
+	FrozenBinarySearchTree(FrozenBinarySearchTree&&) = default; // Moving keeps the buffers and the mapping at the same addresses, so the pointers stay valid.
+	FrozenBinarySearchTree& operator=(FrozenBinarySearchTree&&) = default; // Moving keeps the buffers and the mapping at the same addresses, so the pointers stay valid.
+
+	bool save(const string& filename) const; // This function writes the snapshot to a file in the layout open expects, replacing the file in one step. It returns false if the file cannot be written, which on Windows includes a file that another snapshot still maps.
+	bool open(const string& filename); // This function maps a saved snapshot and queries it in place. It returns false if the file cannot be mapped, is not a snapshot, or has a key outside its characters. The file must not be truncated while it is mapped.
+	vector<string_view> sortedKeys() const; // This function returns the keys of the snapshot in sorted order.
+
+	bool exists(string_view word) const; // This function checks if the given word is in the snapshot.
+	size_t size() const; // This function returns the number of keys in the snapshot.
+	size_t memoryBytes() const; // This function returns the number of bytes used by the entries and the key characters.
+};
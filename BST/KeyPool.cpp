@@ -0,0 +1,65 @@
+/*
+This implementation file provides the implementations for the key pool methods declared in the header file. It defines how keys are appended to the
+pool, how their prefixes are computed and when the pool has wasted enough space to be worth rebuilding.
+*/
+
+#include "KeyPool.h" // This is a header file that contains the declaration of the key pool.
+#include <algorithm> // This is a header file library that lets us use algorithms such as min.
+
+uint64_t KeyPool::prefixOf(string_view key) { // This function packs the first eight bytes of the key into a number that sorts like the key.
+	uint64_t prefix = 0; // Create a number to store the prefix.
+	size_t count = min(key.size(), static_cast<size_t>(8)); // Only the first eight bytes fit in the number.
+	for (size_t i = 0; i < 8; ++i) { // Loop through the eight bytes of the number, most significant byte first.
+		unsigned char byte = i < count ? static_cast<unsigned char>(key[i]) : 0; // Keys shorter than eight bytes are padded with zeros.
+		prefix = (prefix << 8) | byte; // Shift the previous bytes up and add the next byte.
+	}
+	return prefix; // Return the prefix.
+}
+
+SearchKey KeyPool::makeSearchKey(string_view key) { // This function creates a search key for the given characters.
+	return SearchKey{ key, prefixOf(key) }; // Return the characters together with their prefix.
+}
+
+uint64_t KeyPool::append(string_view key) { // This function copies the key to the end of the pool and returns its offset.
+	uint64_t offset = bytes.size(); // The key starts where the pool currently ends.
+	bytes.append(key.data(), key.size()); // Copy the characters of the key to the end of the pool.
+	return offset; // Return the offset of the key.
+}
+
+char* KeyPool::extend(size_t length) { // This function adds the given number of characters to the end of the pool and returns a pointer to them, so several threads can copy keys into them at once.
+	size_t offset = bytes.size(); // The new characters start where the pool currently ends.
+	bytes.resize(offset + length); // Add the characters. They are filled with zeros until the caller copies the keys in.
+	return &bytes[0] + offset; // Return a pointer to the first new character.
+}
+
+string_view KeyPool::view(uint64_t offset, uint32_t length) const { // This function returns the key stored at the given offset.
+	return string_view(bytes.data() + offset, length); // Return a view of the characters of the key.
+}
+
+const char* KeyPool::data() const { // This function returns a pointer to the first character of the pool.
+	return bytes.data(); // Return the pointer to the characters.
+}
+
+size_t KeyPool::size() const { // This function returns the number of characters in the pool.
+	return bytes.size(); // Return the number of characters.
+}
+
+size_t KeyPool::capacity() const { // This function returns the number of characters the pool has room for before it grows.
+	return bytes.capacity(); // Return the capacity of the characters.
+}
+
+size_t KeyPool::releasedSize() const { // This function returns the number of characters that belong to removed keys.
+	return deadBytes; // Return the number of wasted characters.
+}
+
+void KeyPool::reserve(size_t size) { // This function makes room for the given number of characters.
+	bytes.reserve(size); // Reserve the memory for the characters.
+}
+
+void KeyPool::release(size_t length) { // This function records that a key of the given length is no longer used.
+	deadBytes += length; // Count the characters of the key as wasted.
+}
+
+bool KeyPool::needsCompaction() const { // This function checks if so many keys were removed that the pool should be rebuilt.
+	return bytes.size() > 4096 && deadBytes * 2 > bytes.size(); // Rebuild the pool once more than half of a non-trivial pool is wasted.
+}
@@ -0,0 +1,38 @@
+/*
+This header file defines the key pool that a Binary Search Tree (BST) stores its keys in. Instead of giving every node its own string, the tree appends
+each key to one contiguous block of characters and the node only remembers where the key starts and how long it is. The node also keeps the first eight
+bytes of the key as a number, so most comparisons can be answered with a single integer compare and never have to read the pool.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <string> // This is a header file library that lets us work with strings.
+#include <string_view> // This is a header file library that lets us refer to characters without copying them.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+struct SearchKey { // This struct represents a key that is being looked for, together with its cached prefix.
+	string_view text; // This view refers to the characters of the key.
+	uint64_t prefix; // This number stores the first eight bytes of the key, so it can be compared as an integer.
+};
+
+class KeyPool { // This class stores the keys of a binary search tree in one contiguous block of characters.
+private: // This section contains private members of the class.
+	string bytes; // This string stores the characters of all keys, one after another.
+	size_t deadBytes = 0; // This number stores how many characters belong to keys that were removed from the tree.
+
+public: // This section contains public members of the class.
+	static uint64_t prefixOf(string_view key); // This function packs the first eight bytes of the key into a number that sorts like the key.
+	static SearchKey makeSearchKey(string_view key); // This function creates a search key for the given characters.
+
+	uint64_t append(string_view key); // This function copies the key to the end of the pool and returns its offset.
+	char* extend(size_t length); // This function adds the given number of characters to the end of the pool and returns a pointer to them, so several threads can copy keys into them at once.
+	string_view view(uint64_t offset, uint32_t length) const; // This function returns the key stored at the given offset.
+	const char* data() const; // This function returns a pointer to the first character of the pool.
+	size_t size() const; // This function returns the number of characters in the pool.
+	size_t capacity() const; // This function returns the number of characters the pool has room for before it grows.
+	size_t releasedSize() const; // This function returns the number of characters that belong to removed keys.
+	void reserve(size_t size); // This function makes room for the given number of characters.
+	void release(size_t length); // This function records that a key of the given length is no longer used.
+	bool needsCompaction() const; // This function checks if so many keys were removed that the pool should be rebuilt.
+};
@@ -0,0 +1,103 @@
+/*
+This implementation file provides the implementations for the memory-mapped file declared in the header file. It uses CreateFileMapping and MapViewOfFile
+on Windows and mmap everywhere else.
+*/
+
+#include "MappedFile.h" // This is a header file that contains the declaration of the memory-mapped file.
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN // This macro leaves the rarely used parts out of the Windows header.
+#include <windows.h> // This is a header file library that lets us use the Windows file mapping functions.
+#else
+#include <fcntl.h> // This is a header file library that lets us open files with open.
+#include <sys/mman.h> // This is a header file library that lets us map files with mmap.
+#include <sys/stat.h> // This is a header file library that lets us get the size of a file with fstat.
+#include <unistd.h> // This is a header file library that lets us close files with close.
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data(nullptr), length(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {} // This is the default constructor for a file that is not mapped yet.
+#else
+MappedFile::MappedFile() : data(nullptr), length(0) {} // This is the default constructor for a file that is not mapped yet.
+#endif
+
+MappedFile::~MappedFile() { // This is the destructor, which unmaps the file.
+	close(); // Unmap the file.
+}
+
+bool MappedFile::open(const string& filename) { // This function maps the given file. It returns false if the file cannot be opened or mapped.
+	close(); // Unmap any file that was mapped before.
+#ifdef _WIN32
+	fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr); // Open the file for reading. Windows keeps a mapped file from being deleted or replaced whatever the sharing mode, so other writers have to wait until it is closed.
+	if (fileHandle == INVALID_HANDLE_VALUE) { // If the file cannot be opened, report it to the caller.
+		return false; // Return false to indicate that the file could not be opened.
+	}
+	LARGE_INTEGER size; // Create a variable to store the size of the file.
+	if (!GetFileSizeEx(fileHandle, &size)) { // Get the size of the file.
+		close(); // Close the file.
+		return false; // Return false to indicate that the size could not be read.
+	}
+	length = static_cast<size_t>(size.QuadPart); // Store the size of the file.
+	if (length == 0) { // An empty file cannot be mapped, but it is still a valid file with no characters.
+		return true; // Return true with an empty view.
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr); // Create a read-only mapping object for the whole file.
+	if (mappingHandle == nullptr) { // If the mapping object cannot be created, report it to the caller.
+		close(); // Close the file.
+		return false; // Return false to indicate that the file could not be mapped.
+	}
+	data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0)); // Map the whole file into memory.
+#else
+	int descriptor = ::open(filename.c_str(), O_RDONLY); // Open the file for reading.
+	if (descriptor < 0) { // If the file cannot be opened, report it to the caller.
+		return false; // Return false to indicate that the file could not be opened.
+	}
+	struct stat status; // Create a variable to store information about the file.
+	if (fstat(descriptor, &status) != 0) { // Get the size of the file.
+		::close(descriptor); // Close the file.
+		return false; // Return false to indicate that the size could not be read.
+	}
+	length = static_cast<size_t>(status.st_size); // Store the size of the file.
+	if (length == 0) { // An empty file cannot be mapped, but it is still a valid file with no characters.
+		::close(descriptor); // Close the file.
+		return true; // Return true with an empty view.
+	}
+	void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0); // Map the whole file into memory.
+	::close(descriptor); // The mapping stays valid after the file is closed.
+	if (mapping != MAP_FAILED) { // If the mapping worked, keep it.
+		madvise(mapping, length, MADV_SEQUENTIAL); // Tell the operating system the file is mostly read from start to end, so it reads ahead.
+		data = static_cast<const char*>(mapping); // Store the address of the mapping.
+	}
+#endif
+	if (data == nullptr) { // If the file could not be mapped, report it to the caller.
+		close(); // Release anything that was opened.
+		return false; // Return false to indicate that the file could not be mapped.
+	}
+	return true; // Return true to indicate that the file was mapped.
+}
+
+void MappedFile::close() { // This function unmaps the file.
+#ifdef _WIN32
+	if (data != nullptr) { // If a view is mapped, unmap it.
+		UnmapViewOfFile(data); // Unmap the view.
+	}
+	if (mappingHandle != nullptr) { // If a mapping object exists, close it.
+		CloseHandle(mappingHandle); // Close the mapping object.
+		mappingHandle = nullptr; // Forget the mapping object.
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) { // If the file is open, close it.
+		CloseHandle(fileHandle); // Close the file.
+		fileHandle = INVALID_HANDLE_VALUE; // Forget the file.
+	}
+#else
+	if (data != nullptr) { // If the file is mapped, unmap it.
+		munmap(const_cast<char*>(data), length); // Unmap the file.
+	}
+#endif
+	data = nullptr; // Forget the mapping.
+	length = 0; // The mapping has no characters left.
+}
+
+string_view MappedFile::contents() const { // This function returns the characters of the mapped file.
+	return string_view(data, length); // Return a view of the mapped characters.
+}
@@ -0,0 +1,30 @@
+/*
+This header file defines a read-only memory-mapped file. Mapping a file lets the operating system page its contents in on demand, so the program can
+look at the whole file as one block of characters without reading it through a stream or copying it into a buffer first.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <string> // This is a header file library that lets us work with strings.
+#include <string_view> // This is a header file library that lets us refer to characters without copying them.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+class MappedFile { // This class maps a file into memory for reading and unmaps it when it is destroyed.
+private: // This section contains private members of the class.
+	const char* data; // This pointer points to the first character of the mapped file.
+	size_t length; // This number stores the size of the mapped file in bytes.
+#ifdef _WIN32
+	void* fileHandle; // This handle refers to the open file (Windows only).
+	void* mappingHandle; // This handle refers to the file mapping object (Windows only).
+#endif
+
+public: // This section contains public members of the class.
+	MappedFile(); // This is the default constructor for a file that is not mapped yet.
+	MappedFile(const MappedFile&) = delete; // The mapping can only be unmapped once, so it cannot be copied.
+	MappedFile& operator=(const MappedFile&) = delete; // The mapping can only be unmapped once, so it cannot be copy-assigned.
+	~MappedFile(); // This is the destructor, which unmaps the file.
+
+	bool open(const string& filename); // This function maps the given file. It returns false if the file cannot be opened or mapped.
+	void close(); // This function unmaps the file.
+	string_view contents() const; // This function returns the characters of the mapped file.
+};
@@ -0,0 +1,123 @@
+/*
+This header file defines the node allocators that a Binary Search Tree (BST) can use to get memory for its nodes. NewAllocator gives every node its own
+heap allocation, ArenaAllocator hands out nodes from large slabs and only gives the memory back when the whole arena is released, and PoolAllocator
+works like the arena but also recycles freed nodes through a free list. The allocators are class templates, so the tree can pass one of them as a
+template parameter and the benchmark can compare them.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <new> // This is a header file library that lets us allocate raw memory and construct objects in it.
+#include <type_traits> // This is a header file library that lets us ask questions about types at compile time.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+template <typename T>
+class NewAllocator { // This class allocates every object with its own call to new.
+public: // This section contains public members of the class.
+	static constexpr bool releasesAll = false; // This flag tells the tree that it must delete its nodes one at a time.
+
+	T* allocate() { // This function allocates a new default-constructed object.
+		return new T(); // Allocate and construct the object on the heap.
+	}
+
+	void deallocate(T* object) { // This function destroys an object and frees its memory.
+		delete object; // Delete the object.
+	}
+};
+
+template <typename T>
+class ArenaAllocator { // This class hands out objects from large slabs and frees all of them at once when it is destroyed.
+public: // This section contains public members of the class.
+	static constexpr bool releasesAll = true; // This flag tells the tree that destroying the allocator frees all of its nodes.
+
+	ArenaAllocator() = default; // This is the default constructor for the arena.
+	ArenaAllocator(const ArenaAllocator&) = delete; // The arena owns its slabs, so it cannot be copied.
+	ArenaAllocator& operator=(const ArenaAllocator&) = delete; // The arena owns its slabs, so it cannot be copy-assigned.
+
+	~ArenaAllocator() { // This is the destructor for the arena.
+		releaseAll(); // Free every slab at once.
+	}
+
+	T* allocate() { // This function hands out the next free slot of the current slab.
+		if (slabs.empty() || used == slabs.back().capacity) { // If there is no slab yet or the current slab is full, allocate a new one.
+			size_t capacity = slabs.empty() ? firstSlabSize : slabs.back().capacity * 2; // Each slab is twice as large as the previous one.
+			if (capacity > maxSlabSize) { // Limit the slab size, so the arena does not over-allocate for large trees.
+				capacity = maxSlabSize; // Use the maximum slab size.
+			}
+			slabs.push_back({ static_cast<T*>(::operator new(capacity * sizeof(T))), capacity }); // Allocate the raw memory for the new slab.
+			used = 0; // The new slab has no used slots yet.
+		}
+		return new (slabs.back().objects + used++) T(); // Construct the object in the next slot and return it.
+	}
+
+	void deallocate(T*) {} // The arena never reuses memory, so freed objects stay in their slab until the arena is released.
+
+	void releaseAll() { // This function destroys every object and frees every slab at once.
+		for (size_t i = 0; i < slabs.size(); ++i) { // Loop through the slabs.
+			if (!is_trivially_destructible<T>::value) { // Objects that own resources must be destroyed before their memory is freed.
+				size_t count = i + 1 == slabs.size() ? used : slabs[i].capacity; // Only the last slab can be partly used.
+				for (size_t j = 0; j < count; ++j) { // Loop through the used slots of the slab.
+					slabs[i].objects[j].~T(); // Destroy the object in the slot.
+				}
+			}
+			::operator delete(slabs[i].objects); // Free the memory of the slab.
+		}
+		slabs.clear(); // Forget the freed slabs.
+		used = 0; // There are no used slots left.
+	}
+
+	size_t bytesReserved() const { // This function returns the number of bytes held by the slabs of the arena.
+		size_t bytes = 0; // Create a counter for the number of bytes.
+		for (const Slab& slab : slabs) { // Loop through the slabs.
+			bytes += slab.capacity * sizeof(T); // Add the size of the slab.
+		}
+		return bytes; // Return the number of bytes.
+	}
+
+private: // This section contains private members of the class.
+	struct Slab { // This struct represents one block of memory that holds many objects.
+		T* objects; // This pointer points to the first slot of the slab.
+		size_t capacity; // This number stores how many objects fit in the slab.
+	};
+
+	static constexpr size_t firstSlabSize = 64; // This is the number of objects in the first slab.
+	static constexpr size_t maxSlabSize = 65536; // This is the largest number of objects in a single slab.
+
+	vector<Slab> slabs; // This vector stores the slabs of the arena.
+	size_t used = 0; // This number stores how many slots of the last slab are in use.
+};
+
+template <typename T>
+class PoolAllocator { // This class hands out objects from an arena and recycles freed objects through a free list.
+public: // This section contains public members of the class.
+	static constexpr bool releasesAll = true; // This flag tells the tree that destroying the allocator frees all of its nodes.
+
+	T* allocate() { // This function reuses a freed object if there is one, or takes a new one from the arena otherwise.
+		if (freeList.empty()) { // If there are no freed objects, take a new one from the arena.
+			return arena.allocate(); // Return a new object from the arena.
+		}
+		T* object = freeList.back(); // Take the most recently freed object, which is most likely still in the cache.
+		freeList.pop_back(); // Remove the object from the free list.
+		*object = T(); // Reset the object to its default state.
+		return object; // Return the recycled object.
+	}
+
+	void deallocate(T* object) { // This function puts a freed object on the free list, so the next allocation can reuse it.
+		freeList.push_back(object); // Add the object to the free list. It stays constructed, so the arena can destroy it later.
+	}
+
+	void releaseAll() { // This function destroys every object and frees every slab at once.
+		freeList.clear(); // Forget the freed objects.
+		arena.releaseAll(); // Free the slabs of the arena.
+	}
+
+	size_t bytesReserved() const { // This function returns the number of bytes held by the pool.
+		return arena.bytesReserved() + freeList.capacity() * sizeof(T*); // Add the size of the slabs and of the free list.
+	}
+
+private: // This section contains private members of the class.
+	ArenaAllocator<T> arena; // This arena provides the memory for new objects.
+	vector<T*> freeList; // This vector stores the objects that were freed and can be reused.
+};
@@ -0,0 +1,188 @@
+/*
+This implementation file provides the implementations for the work-stealing task pool declared in the header file. Every queue has its own lock, so
+threads only wait for each other when one of them is stealing from the other, and idle threads sleep on a condition variable instead of spinning.
+Outside threads that call while queue 0 is taken register a queue of their own, which the pool's threads steal from like any other.
+*/
+
+#include "TaskPool.h" // This is a header file that contains the declaration of the task pool.
+#include <algorithm> // This is a header file library that lets us use algorithms such as find.
+
+thread_local TaskPool* TaskPool::currentPool = nullptr; // The current thread does not work in any pool until it calls invoke or is started by one.
+thread_local TaskPool::Queue* TaskPool::currentQueue = nullptr; // The current thread has no queue until it works in a pool.
+
+TaskPool::TaskPool(unsigned threadCount) : queueCount(threadCount == 0 ? 1 : threadCount), queues(new Queue[threadCount == 0 ? 1 : threadCount]), callerQueueTaken(false), extraCount(0), stopping(false), queued(0), sleeping(0) { // This is a constructor for a pool of the given number of threads, including the thread that calls invoke.
+	for (unsigned i = 0; i < queueCount; ++i) { // Loop through the queues.
+		queues[i].firstVictim = (i + 1) % queueCount; // Let the thread of the queue steal from the next queue first, so thieves spread out.
+	}
+	for (unsigned i = 1; i < queueCount; ++i) { // Loop through the queues of the pool's threads. Queue 0 belongs to the caller.
+		threads.emplace_back(&TaskPool::workerLoop, this, i); // Start the thread.
+	}
+}
+
+TaskPool::~TaskPool() { // This is the destructor, which stops and joins the threads.
+	{
+		lock_guard<mutex> guard(sleepLock); // Hold the lock, so no thread can miss the wake-up.
+		stopping.store(true); // Tell the threads to stop.
+	}
+	wake.notify_all(); // Wake up every sleeping thread.
+	for (thread& worker : threads) { // Loop through the threads.
+		worker.join(); // Wait for the thread to finish.
+	}
+}
+
+TaskPool& TaskPool::shared() { // This function returns a pool with one thread per hardware thread, created the first time it is used.
+	static TaskPool pool; // Create the pool the first time the function runs.
+	return pool; // Return the pool.
+}
+
+unsigned TaskPool::threadCount() const { // This function returns the number of threads that run tasks, including the thread that calls invoke.
+	return queueCount; // Every thread has one queue.
+}
+
+TaskPool::Scope::Scope(TaskPool& pool) : previousPool(currentPool), previousQueue(currentQueue), queue(currentQueue), caller(currentPool != &pool), pool(pool) { // This is the constructor, which finds or borrows a queue.
+	if (!caller) { // If the thread already works in this pool, it keeps its queue.
+		return; // Return with the current queue.
+	}
+	if (!pool.callerQueueTaken.exchange(true, memory_order_acquire)) { // If no other outside thread uses queue 0, borrow it.
+		queue = &pool.queues[0]; // Use queue 0.
+	}
+	else { // Otherwise, another outside thread is running a parallel operation, so this one gets a queue of its own instead of waiting for it.
+		ownQueue.reset(new Queue()); // Create the queue.
+		queue = ownQueue.get(); // Use it.
+		lock_guard<mutex> guard(pool.extraLock); // Lock the extra queues.
+		pool.extraQueues.push_back(queue); // Register the queue, so the pool's threads can steal from it.
+		pool.extraCount.fetch_add(1); // Count the queue.
+	}
+	currentPool = &pool; // Work in this pool.
+	currentQueue = queue; // Use the borrowed queue.
+}
+
+TaskPool::Scope::~Scope() { // This is the destructor, which gives a borrowed queue back.
+	if (!caller) { // If the thread kept its queue, there is nothing to give back.
+		return; // Return without changing anything.
+	}
+	currentPool = previousPool; // Go back to the pool the thread worked in before.
+	currentQueue = previousQueue; // Go back to the queue the thread used before.
+	if (ownQueue == nullptr) { // If the thread borrowed queue 0, give it back.
+		pool.callerQueueTaken.store(false, memory_order_release); // Let the next outside thread use queue 0.
+		return; // Return after giving the queue back.
+	}
+	lock_guard<mutex> guard(pool.extraLock); // Lock the extra queues, so no thread is stealing from this one when it is freed. Every task in it has been joined, so it is empty.
+	pool.extraQueues.erase(find(pool.extraQueues.begin(), pool.extraQueues.end(), queue)); // Unregister the queue.
+	pool.extraCount.fetch_sub(1); // Stop counting the queue.
+}
+
+void TaskPool::push(Queue& queue, Task* task) { // This function adds a task to the back of the given queue.
+	{
+		lock_guard<mutex> guard(queue.lock); // Lock the queue.
+		queue.tasks.push_back(task); // Add the task.
+	}
+	queued.fetch_add(1); // Count the task. This must come before the check below, so a thread that is about to sleep sees it.
+	if (sleeping.load() > 0) { // If a thread is sleeping, wake it up to steal the task.
+		lock_guard<mutex> guard(sleepLock); // Hold the lock, so the wake-up cannot arrive before the thread waits.
+		wake.notify_one(); // Wake up one thread.
+	}
+}
+
+bool TaskPool::popIfBack(Queue& queue, Task* task) { // This function removes the task from the back of the given queue, if nobody stole it.
+	lock_guard<mutex> guard(queue.lock); // Lock the queue.
+	deque<Task*>& tasks = queue.tasks; // Get the tasks of the queue.
+	if (tasks.empty() || tasks.back() != task) { // Nested calls always take their own tasks back first, so if the task is not at the back, it was stolen.
+		return false; // Return false to indicate that the task was stolen.
+	}
+	tasks.pop_back(); // Remove the task.
+	queued.fetch_sub(1); // Stop counting the task.
+	return true; // Return true to indicate that the task is back.
+}
+
+TaskPool::Task* TaskPool::take(Queue& queue) { // This function takes a task from the given queue, or steals one from another queue.
+	{
+		lock_guard<mutex> guard(queue.lock); // Lock the own queue.
+		deque<Task*>& tasks = queue.tasks; // Get the tasks of the queue.
+		if (!tasks.empty()) { // If the own queue has a task, take the newest one, which is the smallest and the one whose data is still in the cache.
+			Task* task = tasks.back(); // Get the task.
+			tasks.pop_back(); // Remove the task.
+			queued.fetch_sub(1); // Stop counting the task.
+			return task; // Return the task.
+		}
+	}
+	for (unsigned offset = 0; offset < queueCount; ++offset) { // Loop through the queues of the array, starting after the own one, so thieves spread out.
+		Queue& victim = queues[(queue.firstVictim + offset) % queueCount]; // Get the queue to steal from.
+		if (&victim != &queue) { // The own queue was already checked.
+			if (Task* task = stealFrom(victim)) { // If the queue has a task, steal it.
+				return task; // Return the task.
+			}
+		}
+	}
+	if (extraCount.load() > 0) { // If outside threads are calling with queues of their own, steal from those too.
+		lock_guard<mutex> guard(extraLock); // Lock the extra queues, so none of them is freed while it is being looked at.
+		for (Queue* victim : extraQueues) { // Loop through the extra queues.
+			if (victim != &queue) { // The own queue was already checked.
+				if (Task* task = stealFrom(*victim)) { // If the queue has a task, steal it.
+					return task; // Return the task.
+				}
+			}
+		}
+	}
+	return nullptr; // Return null to indicate that there is no work.
+}
+
+TaskPool::Task* TaskPool::stealFrom(Queue& victim) { // This function takes the oldest task from another thread's queue, or returns null if it is empty.
+	lock_guard<mutex> guard(victim.lock); // Lock the queue.
+	if (victim.tasks.empty()) { // If the queue has no task, there is nothing to steal.
+		return nullptr; // Return null.
+	}
+	Task* task = victim.tasks.front(); // Steal the oldest task, which is usually the largest.
+	victim.tasks.pop_front(); // Remove the task.
+	queued.fetch_sub(1); // Stop counting the task.
+	return task; // Return the task.
+}
+
+void TaskPool::execute(Task* task) { // This function runs a stolen task and marks it as done.
+	try { // Run the task, keeping any exception for the thread that waits for it.
+		task->run(task->function); // Run the task.
+	}
+	catch (...) { // If the task throws, store the exception.
+		task->error = current_exception(); // Store the exception.
+	}
+	task->done.store(true, memory_order_release); // Mark the task as done. The waiting thread may free it right after this.
+}
+
+void TaskPool::join(Queue& queue, Task* task, bool rethrow) { // This function runs the task if it is still queued, or helps with other tasks until the thief is done.
+	if (popIfBack(queue, task)) { // If nobody stole the task, run it here.
+		if (rethrow) { // If the caller wants the exception, run the task directly.
+			task->run(task->function); // Run the task.
+		}
+		return; // Return after the task is done, or dropped.
+	}
+	while (!task->done.load(memory_order_acquire)) { // Wait until the thief has finished the task.
+		Task* other = take(queue); // Look for other work in the meantime, which is often a piece of the stolen task.
+		if (other != nullptr) { // If there is work, run it.
+			execute(other); // Run the task.
+		}
+		else { // Otherwise, let other threads run.
+			this_thread::yield(); // Give up the rest of the time slice.
+		}
+	}
+	if (rethrow && task->error) { // If the task threw on another thread, pass the exception on.
+		rethrow_exception(task->error); // Throw the exception here.
+	}
+}
+
+void TaskPool::workerLoop(unsigned index) { // This function runs tasks on one of the pool's threads until the pool stops.
+	currentPool = this; // The thread works in this pool.
+	currentQueue = &queues[index]; // The thread uses its own queue.
+	while (!stopping.load()) { // Loop until the pool stops.
+		Task* task = take(queues[index]); // Look for work.
+		if (task != nullptr) { // If there is work, run it.
+			execute(task); // Run the task.
+			continue; // Look for more work.
+		}
+		unique_lock<mutex> guard(sleepLock); // Lock the sleeping threads.
+		sleeping.fetch_add(1); // Announce that the thread is about to sleep. This must come before the check below, so a thread that pushes work sees it.
+		if (queued.load() == 0 && !stopping.load()) { // If there is still no work, sleep until there is.
+			wake.wait(guard); // Sleep until a thread pushes work or the pool stops.
+		}
+		sleeping.fetch_sub(1); // Announce that the thread is awake.
+	}
+}
@@ -0,0 +1,118 @@
+/*
+This header file defines a work-stealing task pool for fork-join parallelism. A thread that calls invoke pushes the second half of its work onto its own
+queue and runs the first half itself. An idle thread steals the oldest task from another thread's queue, which is usually the largest piece of work left,
+and the thread that pushed a task runs it itself if nobody stole it. Divide-and-conquer algorithms on trees therefore only pay for a queue operation at
+every split, and the work spreads over all threads without a central queue. Threads from outside the pool share one extra queue while only one of
+them calls at a time; when several call at once, each of the others gets a queue of its own for the call, so they run side by side instead of waiting.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <atomic> // This is a header file library that lets us work with values that are safe to share between threads.
+#include <condition_variable> // This is a header file library that lets idle threads sleep until there is work.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <deque> // This is a header file library that lets us work with double-ended queues.
+#include <exception> // This is a header file library that lets us pass exceptions between threads.
+#include <memory> // This is a header file library that lets us own objects through smart pointers, such as unique_ptr.
+#include <mutex> // This is a header file library that lets us protect shared data with a lock.
+#include <thread> // This is a header file library that lets us run code on several threads.
+#include <type_traits> // This is a header file library that lets us ask questions about types at compile time.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+class TaskPool { // This class runs fork-join tasks on a fixed set of threads that steal work from each other.
+public: // This section contains public members of the class.
+	explicit TaskPool(unsigned threadCount = thread::hardware_concurrency()); // This is a constructor for a pool of the given number of threads, including the thread that calls invoke.
+	TaskPool(const TaskPool&) = delete; // The pool owns its threads, so it cannot be copied.
+	TaskPool& operator=(const TaskPool&) = delete; // The pool owns its threads, so it cannot be copy-assigned.
+	~TaskPool(); // This is the destructor, which stops and joins the threads.
+
+	static TaskPool& shared(); // This function returns a pool with one thread per hardware thread, created the first time it is used.
+	unsigned threadCount() const; // This function returns the number of threads that run tasks, including the thread that calls invoke.
+
+	template <typename Left, typename Right>
+	void invoke(Left&& left, Right&& right) { // This function runs both functions, possibly at the same time, and returns when both are done.
+		if (queueCount == 1) { // If the pool has no other threads, there is nobody to share the work with.
+			left(); // Run the first function.
+			right(); // Run the second function.
+			return; // Return without touching any queue.
+		}
+		Scope scope(*this); // Make sure the current thread has a queue in this pool.
+		Queue& queue = *scope.queue; // Get the queue of the thread.
+		using RightType = typename remove_reference<Right>::type; // Get the type of the second function.
+		Task task; // Create a task for the second function. It lives on this stack frame, because invoke only returns once it is done.
+		task.run = [](void* function) { (*static_cast<RightType*>(function))(); }; // Store a function that calls the second function.
+		task.function = const_cast<void*>(static_cast<const void*>(&right)); // Store the address of the second function.
+		push(queue, &task); // Offer the task to the other threads.
+		try { // Run the first function here, but never leave while the task may still be running somewhere else.
+			left(); // Run the first function.
+		}
+		catch (...) { // If the first function throws, the task still refers to this stack frame.
+			join(queue, &task, false); // Wait for the task to finish, ignoring its own exception.
+			throw; // Pass the exception on.
+		}
+		join(queue, &task, true); // Run the task here if nobody stole it, or wait for the thread that did.
+	}
+
+	template <typename Body>
+	void parallelFor(size_t first, size_t last, size_t grain, const Body& body) { // This function calls body with every index in [first, last), splitting the range until pieces have at most grain indexes.
+		if (last - first <= grain || queueCount == 1) { // If the range is small or nobody can help, run it here.
+			for (size_t i = first; i < last; ++i) { // Loop through the indexes.
+				body(i); // Run the body.
+			}
+			return; // Return after the range is done.
+		}
+		size_t middle = first + (last - first) / 2; // Split the range in half.
+		invoke([&]() { parallelFor(first, middle, grain, body); }, [&]() { parallelFor(middle, last, grain, body); }); // Run both halves.
+	}
+
+private: // This section contains private members of the class.
+	struct Task { // This struct represents a piece of work that another thread may steal.
+		void (*run)(void*) = nullptr; // This function runs the work.
+		void* function = nullptr; // This pointer points to the function object that holds the work.
+		atomic<bool> done{ false }; // This flag is set once a thief has finished the work.
+		exception_ptr error; // This pointer stores the exception the work threw on another thread, if any.
+	};
+
+	struct alignas(64) Queue { // This struct stores the tasks one thread has offered. It fills a cache line, so queues never share one.
+		mutex lock; // This mutex protects the tasks.
+		deque<Task*> tasks; // This queue stores the tasks. The owner uses the back, and thieves take from the front.
+		unsigned firstVictim = 0; // This number stores the queue the owner tries to steal from first. The queues of extra callers start at queue 0.
+	};
+
+	struct Scope { // This struct gives the current thread a queue in the pool for as long as it exists.
+		TaskPool* previousPool; // This pointer stores the pool the thread belonged to before.
+		Queue* previousQueue; // This pointer stores the queue the thread used before.
+		Queue* queue; // This pointer points to the queue the thread uses in this pool.
+		bool caller; // This flag is set if the thread is not one of the pool's threads and borrowed a queue for the call.
+		unique_ptr<Queue> ownQueue; // This queue is used if another outside thread already holds the caller queue. It is only created then.
+
+		explicit Scope(TaskPool& pool); // This is the constructor, which finds or borrows a queue.
+		~Scope(); // This is the destructor, which gives a borrowed queue back.
+		TaskPool& pool; // This reference stores the pool.
+	};
+
+	unsigned queueCount; // This number stores the number of queues. Queue 0 belongs to callers from outside, the others to the pool's threads.
+	unique_ptr<Queue[]> queues; // This array stores the queues.
+	vector<thread> threads; // This vector stores the pool's threads.
+	atomic<bool> callerQueueTaken; // This flag is set while an outside thread uses queue 0.
+	mutex extraLock; // This mutex protects the queues of the other outside threads, so a queue is never freed while a thread steals from it.
+	vector<Queue*> extraQueues; // This vector stores the queues of the outside threads that called while queue 0 was taken.
+	atomic<size_t> extraCount; // This number stores how many such queues there are, so thieves only lock them when there are some.
+	atomic<bool> stopping; // This flag tells the threads to stop.
+	atomic<size_t> queued; // This number stores how many tasks are waiting in all queues.
+	atomic<unsigned> sleeping; // This number stores how many threads are waiting for work.
+	mutex sleepLock; // This mutex protects the sleeping threads.
+	condition_variable wake; // This condition variable wakes up sleeping threads when there is work.
+
+	static thread_local TaskPool* currentPool; // This pointer stores the pool the current thread is working in, if any.
+	static thread_local Queue* currentQueue; // This pointer points to the queue the current thread uses in that pool.
+
+	void push(Queue& queue, Task* task); // This function adds a task to the back of the given queue.
+	bool popIfBack(Queue& queue, Task* task); // This function removes the task from the back of the given queue, if nobody stole it.
+	Task* take(Queue& queue); // This function takes a task from the given queue, or steals one from another queue.
+	Task* stealFrom(Queue& victim); // This function takes the oldest task from another thread's queue, or returns null if it is empty.
+	void execute(Task* task); // This function runs a stolen task and marks it as done.
+	void join(Queue& queue, Task* task, bool rethrow); // This function runs the task if it is still queued, or helps with other tasks until the thief is done.
+	void workerLoop(unsigned index); // This function runs tasks on one of the pool's threads until the pool stops.
+};
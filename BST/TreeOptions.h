@@ -0,0 +1,18 @@
+/*
+This header file defines the options that every Binary Search Tree (BST) in this project understands: how the tree keeps itself balanced and in which
+order a traversal visits the nodes. They live in their own header, so the string tree and the typed tree can share them without including each other.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+
+enum class BalanceMode { // This enum selects how the binary search tree keeps itself balanced.
+	None, // The tree is never rebalanced, so its shape depends on the insertion order.
+	AVL, // The tree is kept as an AVL tree, so the heights of sibling subtrees differ by at most one.
+	RedBlack // The tree is kept as a left-leaning red-black tree, so no path is more than twice as long as any other.
+};
+
+enum class TraversalOrder { // This enum selects the order in which a traversal visits the nodes.
+	Inorder, // The left subtree, then the node, then the right subtree, which gives the keys in sorted order.
+	Preorder, // The node, then the left subtree, then the right subtree.
+	Postorder // The left subtree, then the right subtree, then the node.
+};
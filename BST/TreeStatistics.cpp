@@ -0,0 +1,81 @@
+/*
+This implementation file provides the implementations for the tree statistics declared in the header file. The snapshot is a plain copy of the
+counters, so taking one is cheap, and the percentiles are read from the comparison histogram without storing the individual searches.
+*/
+
+#include "TreeStatistics.h" // This is a header file that contains the declaration of the tree statistics.
+
+uint64_t TreeStatistics::lookupMisses() const { // This function returns how many lookups did not find the key.
+	return lookups - lookupHits; // Every lookup is either a hit or a miss.
+}
+
+uint64_t TreeStatistics::searches() const { // This function returns how many searches the histogram recorded.
+	uint64_t total = 0; // Create a counter for the searches.
+	for (uint64_t count : comparisons) { // Loop through the buckets.
+		total += count; // Add the searches of the bucket.
+	}
+	return total; // Return the number of searches.
+}
+
+double TreeStatistics::averageComparisons() const { // This function returns the mean number of comparisons per search.
+	uint64_t total = 0; // Create a counter for the comparisons.
+	for (size_t i = 0; i < comparisons.size(); ++i) { // Loop through the buckets.
+		total += i * comparisons[i]; // Every search in bucket i needed i comparisons. Searches in the last bucket count as the bucket's minimum.
+	}
+	uint64_t count = searches(); // Get the number of searches.
+	return count == 0 ? 0.0 : double(total) / count; // Return the mean, or 0 if there were no searches.
+}
+
+size_t TreeStatistics::comparisonPercentile(double fraction) const { // This function returns the number of comparisons the given fraction of the searches stayed within.
+	uint64_t count = searches(); // Get the number of searches.
+	uint64_t needed = static_cast<uint64_t>(fraction * count + 0.5); // Calculate how many searches have to be covered.
+	uint64_t covered = 0; // Create a counter for the searches covered so far.
+	for (size_t i = 0; i < comparisons.size(); ++i) { // Loop through the buckets in increasing order.
+		covered += comparisons[i]; // Cover the searches of the bucket.
+		if (covered >= needed && covered > 0) { // If enough searches are covered, the bucket is the percentile.
+			return i; // Return the number of comparisons of the bucket.
+		}
+	}
+	return 0; // Return 0 if there were no searches.
+}
+
+void StatisticsCounters::copyTo(TreeStatistics& statistics) const { // This function copies the counters into the snapshot.
+	statistics.inserts = inserts.load(memory_order_relaxed); // Copy the number of inserts.
+	statistics.insertedKeys = insertedKeys.load(memory_order_relaxed); // Copy the number of new keys.
+	statistics.removes = removes.load(memory_order_relaxed); // Copy the number of removes.
+	statistics.removedKeys = removedKeys.load(memory_order_relaxed); // Copy the number of removed keys.
+	statistics.lookups = lookups.load(memory_order_relaxed); // Copy the number of lookups.
+	statistics.lookupHits = lookupHits.load(memory_order_relaxed); // Copy the number of hits.
+	statistics.rotations = rotations.load(memory_order_relaxed); // Copy the number of rotations.
+	statistics.compactions = compactions.load(memory_order_relaxed); // Copy the number of key pool rebuilds.
+	statistics.rebuilds = rebuilds.load(memory_order_relaxed); // Copy the number of tree rebuilds.
+	for (size_t i = 0; i < comparisons.size(); ++i) { // Loop through the buckets.
+		statistics.comparisons[i] = comparisons[i].load(memory_order_relaxed); // Copy the bucket.
+	}
+}
+
+void StatisticsCounters::reset() { // This function sets every counter back to zero.
+	for (atomic<uint64_t>* counter : { &inserts, &insertedKeys, &removes, &removedKeys, &lookups, &lookupHits, &rotations, &compactions, &rebuilds }) { // Loop through the counters.
+		counter->store(0, memory_order_relaxed); // Clear the counter.
+	}
+	for (atomic<uint64_t>& bucket : comparisons) { // Loop through the buckets.
+		bucket.store(0, memory_order_relaxed); // Clear the bucket.
+	}
+}
+
+ostream& operator<<(ostream& out, const TreeStatistics& statistics) { // This function writes the counters and the memory as one line of name=value pairs, so they can be logged and parsed.
+	out << "size=" << statistics.size << " inserts=" << statistics.inserts << " inserted=" << statistics.insertedKeys; // Write the size and the inserts.
+	out << " removes=" << statistics.removes << " removed=" << statistics.removedKeys; // Write the removes.
+	out << " lookups=" << statistics.lookups << " hits=" << statistics.lookupHits << " misses=" << statistics.lookupMisses(); // Write the lookups.
+	out << " rotations=" << statistics.rotations << " compactions=" << statistics.compactions << " rebuilds=" << statistics.rebuilds; // Write the balancing and rebuild work.
+	out << " comparisons_mean=" << statistics.averageComparisons() << " comparisons_p50=" << statistics.comparisonPercentile(0.5) << " comparisons_p99=" << statistics.comparisonPercentile(0.99); // Write the summary of the histogram.
+	out << " node_bytes=" << statistics.nodeBytes << " node_bytes_reserved=" << statistics.nodeBytesReserved; // Write the memory of the nodes.
+	out << " key_bytes=" << statistics.keyBytes << " key_bytes_released=" << statistics.keyBytesReleased << " key_bytes_reserved=" << statistics.keyBytesReserved; // Write the memory of the keys.
+	return out; // Return the stream, so writes can be chained.
+}
+
+ostream& operator<<(ostream& out, const TreeShape& shape) { // This function writes the shape as one line of name=value pairs.
+	out << "size=" << shape.size << " leaves=" << shape.leaves << " height=" << shape.height << " minimum_height=" << shape.minimumHeight; // Write the size and the height.
+	out << " average_depth=" << shape.averageDepth << " max_imbalance=" << shape.maxImbalance; // Write the depth and the balance.
+	return out; // Return the stream, so writes can be chained.
+}
@@ -0,0 +1,166 @@
+/*
+This header file defines the statistics a Binary Search Tree (BST) can keep about itself. They are only collected when the program is built with
+BST_ENABLE_STATS defined: the tree then counts its inserts, removes and lookups, records how many comparisons every search needed, and can report
+its shape and how much memory its nodes and keys take. Without the flag, the BST_STATS macro removes every counting statement, so the tree runs
+exactly as fast as before and has no statistics functions at all.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <array> // This is a header file library that lets us work with arrays of fixed size.
+#include <atomic> // This is a header file library that lets us work with counters that are safe to share between threads.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <iostream> // This is a header file library that lets us work with output objects, such as ostream.
+#include <cstdlib> // This is a header file library that lets us use abs.
+#include <algorithm> // This is a header file library that lets us use algorithms such as max.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+#ifdef BST_ENABLE_STATS
+#define BST_STATS(statement) statement // Statistics are enabled, so the statement is compiled.
+#else
+#define BST_STATS(statement) // Statistics are disabled, so the statement is removed.
+#endif
+
+struct TreeStatistics { // This struct stores a snapshot of the operation counters and the memory of a binary search tree.
+	static constexpr size_t histogramBuckets = 64; // This is the number of buckets in the comparison histogram. The last bucket also counts longer searches.
+
+	uint64_t inserts = 0; // This number stores how many times insert was called.
+	uint64_t insertedKeys = 0; // This number stores how many of those inserts added a new key.
+	uint64_t removes = 0; // This number stores how many times remove was called.
+	uint64_t removedKeys = 0; // This number stores how many of those removes found the key.
+	uint64_t lookups = 0; // This number stores how many times exists was called.
+	uint64_t lookupHits = 0; // This number stores how many of those lookups found the key.
+	uint64_t rotations = 0; // This number stores how many rotations the balancing did.
+	uint64_t compactions = 0; // This number stores how many times the key pool was rebuilt to drop removed keys.
+	uint64_t rebuilds = 0; // This number stores how many times the whole tree was rebuilt, by bulk loads, merges, copies and set operations.
+	array<uint64_t, histogramBuckets> comparisons{}; // This array stores how many searches needed each number of key comparisons.
+
+	size_t size = 0; // This number stores how many keys the tree held.
+	size_t nodeBytes = 0; // This number stores the memory of the nodes in the tree.
+	size_t nodeBytesReserved = 0; // This number stores the memory the node allocator holds, including free slots.
+	size_t keyBytes = 0; // This number stores the number of characters in the key pool.
+	size_t keyBytesReleased = 0; // This number stores how many of those characters belong to removed keys.
+	size_t keyBytesReserved = 0; // This number stores the memory the key pool holds, including room to grow.
+
+	uint64_t lookupMisses() const; // This function returns how many lookups did not find the key.
+	uint64_t searches() const; // This function returns how many searches the histogram recorded.
+	double averageComparisons() const; // This function returns the mean number of comparisons per search.
+	size_t comparisonPercentile(double fraction) const; // This function returns the number of comparisons the given fraction of the searches stayed within.
+};
+
+struct TreeShape { // This struct stores the shape of a binary search tree at one moment.
+	size_t size = 0; // This number stores how many nodes the tree has.
+	size_t leaves = 0; // This number stores how many nodes have no children.
+	int height = 0; // This number stores the number of nodes on the longest path from the root to a leaf.
+	int minimumHeight = 0; // This number stores the height of a perfectly balanced tree of the same size.
+	double averageDepth = 0; // This number stores the mean number of nodes on the path from the root to a node, which is the mean cost of a successful search.
+	int maxImbalance = 0; // This number stores the largest height difference between the two subtrees of any node.
+};
+
+class StatisticsCounters { // This class counts the operations of a binary search tree. Const lookups count too, so the counters are atomic.
+private: // This section contains private members of the class.
+	atomic<uint64_t> inserts{ 0 }; // This counter stores how many times insert was called.
+	atomic<uint64_t> insertedKeys{ 0 }; // This counter stores how many of those inserts added a new key.
+	atomic<uint64_t> removes{ 0 }; // This counter stores how many times remove was called.
+	atomic<uint64_t> removedKeys{ 0 }; // This counter stores how many of those removes found the key.
+	atomic<uint64_t> lookups{ 0 }; // This counter stores how many times exists was called.
+	atomic<uint64_t> lookupHits{ 0 }; // This counter stores how many of those lookups found the key.
+	atomic<uint64_t> rotations{ 0 }; // This counter stores how many rotations the balancing did.
+	atomic<uint64_t> compactions{ 0 }; // This counter stores how many times the key pool was rebuilt.
+	atomic<uint64_t> rebuilds{ 0 }; // This counter stores how many times the whole tree was rebuilt.
+	array<atomic<uint64_t>, TreeStatistics::histogramBuckets> comparisons{}; // This array counts the searches by their number of comparisons.
+
+	static void add(atomic<uint64_t>& counter, uint64_t amount) { // This function adds the amount to the counter. A separate load and store is a plain add without a locked instruction, so readers on several threads may lose a count but never race.
+		counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed); // Add the amount to the counter.
+	}
+
+	static void increment(atomic<uint64_t>& counter) { // This function adds one to the counter.
+		add(counter, 1); // Add one to the counter.
+	}
+
+public: // This section contains public members of the class.
+	void countInsert(bool added) { // This function counts an insert and whether it added a key.
+		increment(inserts); // Count the call.
+		if (added) { // If the key was new, count it.
+			increment(insertedKeys); // Count the new key.
+		}
+	}
+
+	void countInserts(uint64_t count, uint64_t added) { // This function counts a batch of inserts, of which the given number added a key.
+		add(inserts, count); // Count the keys of the batch.
+		add(insertedKeys, added); // Count the new keys.
+	}
+
+	void countRemove(bool found) { // This function counts a remove and whether it found the key.
+		increment(removes); // Count the call.
+		if (found) { // If the key was in the tree, count it.
+			increment(removedKeys); // Count the removed key.
+		}
+	}
+
+	void countLookup(bool found) { // This function counts a lookup and whether it found the key.
+		increment(lookups); // Count the call.
+		if (found) { // If the key was in the tree, count the hit.
+			increment(lookupHits); // Count the hit.
+		}
+	}
+
+	void countSearch(size_t comparisonCount) { // This function records how many comparisons a search needed.
+		increment(comparisons[comparisonCount < TreeStatistics::histogramBuckets ? comparisonCount : TreeStatistics::histogramBuckets - 1]); // Count the search in its bucket, or in the last bucket if it was longer.
+	}
+
+	void countRotation() { increment(rotations); } // This function counts a rotation.
+	void countCompaction() { increment(compactions); } // This function counts a rebuild of the key pool.
+	void countRebuild() { increment(rebuilds); } // This function counts a rebuild of the whole tree.
+
+	void copyTo(TreeStatistics& statistics) const; // This function copies the counters into the snapshot.
+	void reset(); // This function sets every counter back to zero.
+};
+
+ostream& operator<<(ostream& out, const TreeStatistics& statistics); // This function writes the counters and the memory as one line of name=value pairs, so they can be logged and parsed.
+ostream& operator<<(ostream& out, const TreeShape& shape); // This function writes the shape as one line of name=value pairs.
+
+template <typename NodeType, typename Children>
+TreeShape measureShape(const NodeType* root, size_t size, Children children) { // This function walks a tree and returns its shape. Children returns the left and right child of a node as a pair, so every tree can describe its own nodes.
+	TreeShape result; // Create the shape.
+	result.size = size; // Store the number of nodes.
+	while ((size_t(1) << result.minimumHeight) - 1 < size) { // A perfectly balanced tree of height h holds up to 2^h - 1 nodes.
+		++result.minimumHeight; // Try the next height.
+	}
+	struct Frame { const NodeType* node; int depth; bool expanded; }; // This struct stores a node that is being walked, its depth, and whether its children were added yet.
+	vector<Frame> stack; // Create a stack of nodes that still have to be finished.
+	vector<int> heights; // Create a stack of the heights of finished subtrees, so every node can read the heights of its children.
+	uint64_t depthSum = 0; // Create a counter for the depths of all nodes.
+	stack.push_back({ root, 1, false }); // Start at the root, which has depth 1.
+	while (!stack.empty()) { // Walk the tree in postorder without recursion, so deep unbalanced trees do not overflow the stack.
+		Frame frame = stack.back(); // Get the top frame. It is copied, because pushing children may move the stack.
+		if (frame.node == nullptr) { // An empty subtree has height 0.
+			stack.pop_back(); // Finish the empty subtree.
+			heights.push_back(0); // Store its height.
+			continue; // Move on to the next frame.
+		}
+		auto [left, right] = children(frame.node); // Get the children of the node.
+		if (!frame.expanded) { // The first time a node is seen, count its depth and add its children.
+			stack.back().expanded = true; // Remember that the children were added.
+			depthSum += frame.depth; // Count the depth of the node.
+			stack.push_back({ right, frame.depth + 1, false }); // Add the right child, so it is finished second.
+			stack.push_back({ left, frame.depth + 1, false }); // Add the left child, so it is finished first.
+			continue; // Walk the children first.
+		}
+		stack.pop_back(); // The second time, both subtrees are finished, so the node is too.
+		int rightHeight = heights.back(); // Get the height of the right subtree, which was finished last.
+		heights.pop_back(); // Remove it from the stack.
+		int leftHeight = heights.back(); // Get the height of the left subtree.
+		heights.pop_back(); // Remove it from the stack.
+		result.maxImbalance = max(result.maxImbalance, abs(leftHeight - rightHeight)); // Keep the largest height difference.
+		if (left == nullptr && right == nullptr) { // A node without children is a leaf.
+			++result.leaves; // Count the leaf.
+		}
+		heights.push_back(1 + max(leftHeight, rightHeight)); // Store the height of the subtree.
+	}
+	result.height = heights.back(); // The last height on the stack belongs to the whole tree.
+	result.averageDepth = size == 0 ? 0.0 : double(depthSum) / size; // Calculate the mean depth.
+	return result; // Return the shape.
+}
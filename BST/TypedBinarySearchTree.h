@@ -0,0 +1,358 @@
+/*
+This header file defines a Binary Search Tree (BST) for any key type and ordering, which can also store a value with every key and then works as a map.
+The string tree in BinarySearchTree.h packs its keys into a key pool and compares cached prefixes, which only makes sense for strings; this tree keeps
+each key in its node instead, so integer IDs are stored and compared as integers and never have to be formatted as strings. It supports the same three
+balancing modes and node allocators as the string tree, and both take their rotations and rebalancing from BalancedTree.h.
+
+Integral keys ordered by less or greater take a specialized path chosen at compile time: the key sits right after the two child pointers with the
+balancing fields packed behind it, so a set of 32-bit keys needs 24 bytes per node, and a search tests for equality once and then picks the child
+with the result of the comparison as an index instead of branching on it.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <algorithm> // This is a header file library that lets us use algorithms such as max.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as int16_t.
+#include <functional> // This is a header file library that lets us use the standard orderings less and greater.
+#include <queue> // This is a header file library that lets us work with first-in first-out queues.
+#include <type_traits> // This is a header file library that lets us ask questions about types at compile time.
+#include <utility> // This is a header file library that lets us work with pairs.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+#include "TreeOptions.h" // This is a header file that contains the balancing modes and traversal orders shared by the trees.
+#include "NodeAllocator.h" // This is a header file that contains the allocators the tree can take its nodes from.
+#include "TreeStatistics.h" // This is a header file that contains the statistics the tree keeps when BST_ENABLE_STATS is defined.
+#include "BalancedTree.h" // This is a header file that contains the balancing core the tree shares with the string tree.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+template <typename Key, typename Value>
+struct TypedNode { // This struct represents a node of a typed binary search tree that stores a value with its key.
+	TypedNode* children[2] = { nullptr, nullptr }; // This array stores the left child at index 0 and the right child at index 1, so a comparison result can pick the child.
+	Key key{}; // This variable stores the key of the node.
+	int16_t height = 1; // This integer stores the height of the subtree rooted at the node (used by AVL mode).
+	bool red = true; // This flag stores the color of the link from the parent to the node (used by red-black mode).
+	Value value{}; // This variable stores the value that belongs to the key.
+
+	TypedNode*& child(int side) { // This function returns the link to the left child for side 0 and to the right child for side 1.
+		return children[side]; // Return the link from the array.
+	}
+};
+
+template <typename Key>
+struct TypedNode<Key, void> { // This struct represents a node of a typed binary search tree that only stores a key, so the tree works as a set.
+	TypedNode* children[2] = { nullptr, nullptr }; // This array stores the left child at index 0 and the right child at index 1, so a comparison result can pick the child.
+	Key key{}; // This variable stores the key of the node.
+	int16_t height = 1; // This integer stores the height of the subtree rooted at the node (used by AVL mode).
+	bool red = true; // This flag stores the color of the link from the parent to the node (used by red-black mode).
+
+	TypedNode*& child(int side) { // This function returns the link to the left child for side 0 and to the right child for side 1.
+		return children[side]; // Return the link from the array.
+	}
+};
+
+template <typename Key, typename Compare = less<Key>, typename Value = void, template <typename> class Allocator = PoolAllocator>
+class TypedBinarySearchTree : private BalancedTree<TypedNode<Key, Value>> { // This class represents a binary search tree of keys of any type, ordered by Compare, with a value for every key unless Value is void.
+public: // This section contains public members of the class.
+	using Node = TypedNode<Key, Value>; // This is the type of the nodes of the tree.
+	static constexpr bool isMap = !is_void<Value>::value; // This flag is set if the tree stores a value with every key.
+	static constexpr bool integralKeys = is_integral<Key>::value && (is_same<Compare, less<Key>>::value || is_same<Compare, greater<Key>>::value); // This flag is set if keys can be compared with the integer fast path.
+
+private: // This section contains private members of the class.
+	using Base = BalancedTree<Node>; // This is the balancing core the tree shares with the string tree.
+	using Base::root; // This pointer points to the root node of the tree. It lives in the core, which rotates it.
+	using Base::mode; // This value stores the balancing strategy used by the tree.
+	using Base::nodeCount; // This number stores how many nodes are in the tree.
+#ifdef BST_ENABLE_STATS
+	using Base::counters; // This object counts the operations of the tree. The core counts the rotations in it.
+#endif
+	Compare compare; // This object orders the keys.
+	Allocator<Node> nodes; // This allocator provides the memory for the nodes of the tree.
+
+	int compareKey(const Key& key, const Node* node) const { // This function compares the given key with the key of the node and returns a negative, zero or positive number.
+		if constexpr (integralKeys) { // Integers give the order as the difference of two comparisons, without a branch.
+			int order = (key > node->key) - (key < node->key); // Calculate -1, 0 or 1 for ascending order.
+			return is_same<Compare, less<Key>>::value ? order : -order; // Reverse the order if the keys are sorted by greater.
+		}
+		else { // Other keys only have the strict ordering, which needs up to two calls.
+			if (compare(key, node->key)) { // If the key comes first, it is smaller.
+				return -1; // Return a negative number.
+			}
+			return compare(node->key, key) ? 1 : 0; // If the node's key comes first, the key is larger, otherwise they are equal.
+		}
+	}
+
+	Node* findNode(const Key& key) const { // This function finds the node with the given key, or returns null.
+		Node* node = root; // Start at the root.
+		BST_STATS(size_t comparisons = 0;) // Create a counter for the comparisons of the search.
+		if constexpr (integralKeys) { // Integers test for equality once and then index the children with the order.
+			while (node != nullptr && node->key != key) { // Walk down until the key is found or the subtree is empty.
+				BST_STATS(++comparisons;) // Count the comparison.
+				node = node->children[compare(node->key, key)]; // Move right if the node's key comes first, and left otherwise, without a branch.
+			}
+			BST_STATS(comparisons += node != nullptr ? 1 : 0;) // Count the comparison that found the key.
+		}
+		else { // Other keys branch on the three-way comparison.
+			while (node != nullptr) { // Walk down until the key is found or the subtree is empty.
+				int comparison = compareKey(key, node); // Compare the given key with the current node's key.
+				BST_STATS(++comparisons;) // Count the comparison.
+				if (comparison == 0) { // If the key matches the current node's key, stop.
+					break; // Stop the walk at the node.
+				}
+				node = node->children[comparison > 0]; // Move to the subtree the key belongs to.
+			}
+		}
+		BST_STATS(counters.countSearch(comparisons);) // Record the length of the search.
+		return node; // Return the node, or null if the key is not in the tree.
+	}
+
+	Node* insertKey(const Key& key, bool& added) { // This function inserts the key unless it is there already, and returns the node that holds it.
+		return this->insertNode([this, &key](const Node* node) { return compareKey(key, node); }, // Order the key against the nodes on the search path,
+			[this, &key]() { Node* node = nodes.allocate(); node->key = key; return node; }, added); // and store it in a node from the allocator if it is new.
+	}
+
+	Node* cloneTree(const Node* source) { // This function copies the subtree node by node, keeping its shape, without recursion.
+		if (source == nullptr) { // An empty subtree has nothing to copy.
+			return nullptr; // Return null.
+		}
+		auto cloneNode = [this](const Node* original) { // Create a function that copies one node without its children.
+			Node* copy = nodes.allocate(); // Take a new node from the allocator.
+			copy->key = original->key; // Copy the key.
+			if constexpr (isMap) { // Maps also copy the value.
+				copy->value = original->value; // Copy the value.
+			}
+			copy->height = original->height; // Copy the height.
+			copy->red = original->red; // Copy the color.
+			return copy; // Return the copy.
+		};
+		Node* copyRoot = cloneNode(source); // Copy the root of the subtree.
+		vector<pair<const Node*, Node*>> stack = { { source, copyRoot } }; // Create a stack of copied nodes whose children still have to be copied.
+		while (!stack.empty()) { // Loop until every node has been copied.
+			auto [original, copy] = stack.back(); // Take the next pair of nodes.
+			stack.pop_back(); // Remove the pair from the stack.
+			for (int side = 0; side < 2; ++side) { // Loop through both children.
+				if (original->children[side] != nullptr) { // If the child exists, copy it.
+					copy->children[side] = cloneNode(original->children[side]); // Copy the child and link it.
+					stack.push_back({ original->children[side], copy->children[side] }); // Copy its children later.
+				}
+			}
+		}
+		return copyRoot; // Return the root of the copy.
+	}
+
+	void deleteTree(Node* node) { // This function deletes the subtree without recursion.
+		while (node != nullptr) { // Loop until every node has been deleted.
+			if (node->children[0] != nullptr) { // If the node has a left child, rotate it up, so the nodes are freed without a stack.
+				Node* child = node->children[0]; // Get the left child.
+				node->children[0] = child->children[1]; // Move the right subtree of the child under the node.
+				child->children[1] = node; // Make the node the right child of the child.
+				node = child; // Continue at the child.
+			}
+			else { // Otherwise, the node can be freed and its right subtree is next.
+				Node* next = node->children[1]; // Remember the right subtree.
+				nodes.deallocate(node); // Return the node to the allocator.
+				node = next; // Continue with the right subtree.
+			}
+		}
+	}
+
+	template <typename Visitor>
+	static void visitNode(const Node* node, Visitor& visit) { // This function calls visit with the key of the node, and with its value if the tree is a map.
+		if constexpr (isMap) { // Maps give the visitor the key and the value.
+			visit(node->key, node->value); // Visit the key and the value.
+		}
+		else { // Sets only give the key.
+			visit(node->key); // Visit the key.
+		}
+	}
+
+public: // This section contains public members of the class.
+	explicit TypedBinarySearchTree(BalanceMode mode = BalanceMode::None, const Compare& compare = Compare()) : Base(mode), compare(compare) {} // This is a constructor that creates an empty tree with the given balancing strategy and ordering.
+
+	TypedBinarySearchTree(const TypedBinarySearchTree& rhs) : Base(rhs.mode), compare(rhs.compare) { // This is the copy constructor for the tree. It copies the nodes in the same shape.
+		root = cloneTree(rhs.root); // Copy the nodes of the other tree.
+		nodeCount = rhs.nodeCount; // Copy the number of nodes.
+	}
+
+	TypedBinarySearchTree& operator=(const TypedBinarySearchTree& rhs) { // This is the copy assignment operator for the tree. It copies the nodes in the same shape.
+		if (this != &rhs) { // Assigning a tree to itself changes nothing.
+			clear(); // Free the current nodes.
+			mode = rhs.mode; // Copy the balancing strategy.
+			compare = rhs.compare; // Copy the ordering.
+			root = cloneTree(rhs.root); // Copy the nodes of the other tree.
+			nodeCount = rhs.nodeCount; // Copy the number of nodes.
+		}
+		return *this; // Return the tree, so assignments can be chained.
+	}
+
+	~TypedBinarySearchTree() { // This is the destructor for the tree.
+		if (!Allocator<Node>::releasesAll) { // If the allocator cannot free all nodes at once, free them one at a time.
+			deleteTree(root); // Delete the nodes.
+		} // Otherwise, the allocator frees all nodes at once when it is destroyed.
+	}
+
+	bool insert(const Key& key) { // This function inserts the key into a set. It returns false if the key was already there.
+		static_assert(!isMap, "A map needs a value with every key; use insert(key, value) or operator[]."); // Keys of a map cannot be inserted without a value.
+		bool added = false; // Create a flag to store whether the key was new.
+		insertKey(key, added); // Insert the key.
+		return added; // Return whether the key was new.
+	}
+
+	template <typename V = Value>
+	enable_if_t<!is_void<V>::value, bool> insert(const Key& key, const V& value) { // This function inserts the key with the value into a map. It returns false and keeps the old value if the key was already there.
+		bool added = false; // Create a flag to store whether the key was new.
+		Node* node = insertKey(key, added); // Insert the key.
+		if (added) { // Only a new key takes the value.
+			node->value = value; // Store the value.
+		}
+		return added; // Return whether the key was new.
+	}
+
+	template <typename V = Value>
+	enable_if_t<!is_void<V>::value, bool> insertOrAssign(const Key& key, const V& value) { // This function stores the value for the key in a map, replacing the old value if there was one. It returns true if the key was new.
+		bool added = false; // Create a flag to store whether the key was new.
+		insertKey(key, added)->value = value; // Insert the key and store the value.
+		return added; // Return whether the key was new.
+	}
+
+	template <typename V = Value>
+	enable_if_t<!is_void<V>::value, V&> operator[](const Key& key) { // This function returns the value for the key in a map, inserting a default value first if the key is not there.
+		bool added = false; // Create a flag to store whether the key was new. A new node already holds a default value.
+		return insertKey(key, added)->value; // Insert the key if needed and return its value.
+	}
+
+	template <typename V = Value>
+	enable_if_t<!is_void<V>::value, V*> lookup(const Key& key) { // This function returns a pointer to the value for the key in a map, or null if the key is not there.
+		Node* node = findNode(key); // Find the node.
+		BST_STATS(counters.countLookup(node != nullptr);) // Count the lookup.
+		return node == nullptr ? nullptr : &node->value; // Return the value, or null.
+	}
+
+	template <typename V = Value>
+	enable_if_t<!is_void<V>::value, const V*> lookup(const Key& key) const { // This function returns a pointer to the value for the key in a map, or null if the key is not there.
+		const Node* node = findNode(key); // Find the node.
+		BST_STATS(counters.countLookup(node != nullptr);) // Count the lookup.
+		return node == nullptr ? nullptr : &node->value; // Return the value, or null.
+	}
+
+	bool remove(const Key& key) { // This function removes the key, and its value in a map. It returns false if the key was not there.
+		if (findNode(key) == nullptr) { // If the key is not in the tree, there is nothing to remove.
+			BST_STATS(counters.countRemove(false);) // Count the remove that found nothing.
+			return false; // Return false to indicate that the node was not removed.
+		}
+		BST_STATS(counters.countRemove(true);) // Count the remove.
+		this->removeNode([this, &key](const Node* node) { return compareKey(key, node); }, // Remove the node that holds the key,
+			[this](Node* node) { nodes.deallocate(node); }); // and return it to the allocator.
+		return true; // Return true to indicate that the node was removed.
+	}
+
+	bool exists(const Key& key) const { // This function checks if the key is in the tree.
+		bool found = findNode(key) != nullptr; // Find the node.
+		BST_STATS(counters.countLookup(found);) // Count the lookup.
+		return found; // Return true if the node is found, false otherwise.
+	}
+
+	void clear() { // This function removes every key from the tree.
+		deleteTree(root); // Return every node to the allocator.
+		root = nullptr; // The tree is empty.
+		nodeCount = 0; // There are no nodes left.
+	}
+
+	template <typename Visitor>
+	void forEach(Visitor visit) const { // This function calls visit with every key in sorted order, and with its value if the tree is a map, without recursion.
+		vector<const Node*> stack; // Create a stack of nodes whose left subtree is being visited.
+		const Node* node = root; // Start at the root.
+		while (node != nullptr || !stack.empty()) { // Loop until every node has been visited.
+			for (; node != nullptr; node = node->children[0]) { // Walk down to the smallest node of the current subtree.
+				stack.push_back(node); // Remember the node, so it can be visited after its left subtree.
+			}
+			node = stack.back(); // Take the smallest node that has not been visited yet.
+			stack.pop_back(); // Remove the node from the stack.
+			visitNode(node, visit); // Visit the node.
+			node = node->children[1]; // Visit the right subtree next.
+		}
+	}
+
+	template <typename Visitor>
+	void range(const Key& low, const Key& high, Visitor visit) const { // This function calls visit with every key from low to high, both included, in sorted order. Subtrees outside the range are never entered.
+		vector<const Node*> stack; // Create a stack of nodes in the range whose left subtree is being visited.
+		const Node* node = root; // Start at the root.
+		while (node != nullptr || !stack.empty()) { // Loop until the range is done.
+			while (node != nullptr) { // Walk down to the smallest node of the current subtree that can be in the range.
+				if (compareKey(low, node) > 0) { // If the node is below the range, so is its left subtree.
+					node = node->children[1]; // Skip the node and its left subtree.
+				}
+				else { // Otherwise, the node may be in the range.
+					stack.push_back(node); // Remember the node, so it can be visited after its left subtree.
+					node = node->children[0]; // Move to the left child.
+				}
+			}
+			if (stack.empty()) { // If no node is left, the range is done.
+				return; // Stop the walk.
+			}
+			node = stack.back(); // Take the smallest node that has not been visited yet.
+			stack.pop_back(); // Remove the node from the stack.
+			if (compareKey(high, node) < 0) { // If the node is above the range, every node that is left is too.
+				return; // Stop the walk.
+			}
+			visitNode(node, visit); // Visit the node.
+			node = node->children[1]; // Visit the right subtree next.
+		}
+	}
+
+	int height() const { // This function returns the number of nodes on the longest path from the root to a leaf.
+		int levels = 0; // Create a counter for the number of levels in the tree.
+		queue<const Node*> current; // Create a queue that holds the nodes of the current level.
+		if (root != nullptr) { // If the tree is not empty, start at the root.
+			current.push(root); // Add the root to the queue.
+		}
+		while (!current.empty()) { // Visit the tree one level at a time, so deep unbalanced trees do not overflow the stack.
+			for (size_t count = current.size(); count > 0; --count) { // Loop through the nodes on the current level.
+				const Node* node = current.front(); // Take the next node from the queue.
+				current.pop(); // Remove the node from the queue.
+				for (const Node* child : node->children) { // Loop through the children.
+					if (child != nullptr) { // If the child exists, it is on the next level.
+						current.push(child); // Add the child to the queue.
+					}
+				}
+			}
+			++levels; // Count the level that was just visited.
+		}
+		return levels; // Return the number of levels.
+	}
+
+	BalanceMode balanceMode() const { // This function returns the balancing strategy used by the tree.
+		return mode; // Return the balancing strategy.
+	}
+
+	size_t size() const { // This function returns the number of keys in the tree.
+		return nodeCount; // Return the number of nodes.
+	}
+
+	bool empty() const { // This function checks if the tree has no keys.
+		return nodeCount == 0; // Return true if there are no nodes.
+	}
+
+#ifdef BST_ENABLE_STATS
+	TreeStatistics statistics() const { // This function returns a snapshot of the operation counters, the comparison histogram and the memory of the tree. The keys live in the nodes, so there are no key bytes.
+		TreeStatistics result; // Create the snapshot.
+		counters.copyTo(result); // Copy the counters.
+		result.size = nodeCount; // Store the number of keys.
+		result.nodeBytes = nodeCount * sizeof(Node); // Store the memory of the nodes in the tree.
+		if constexpr (Allocator<Node>::releasesAll) { // Arenas and pools hold slabs, which also contain free slots.
+			result.nodeBytesReserved = nodes.bytesReserved(); // Store the memory of the slabs.
+		}
+		else { // Allocators that allocate every node on its own hold exactly the nodes in the tree.
+			result.nodeBytesReserved = result.nodeBytes; // Store the memory of the nodes, without the overhead of the heap.
+		}
+		return result; // Return the snapshot.
+	}
+
+	TreeShape shape() const { // This function walks the tree and returns its height, average depth and largest imbalance.
+		return measureShape(root, nodeCount, [](const Node* node) { return pair<const Node*, const Node*>(node->children[0], node->children[1]); }); // Measure the tree.
+	}
+
+	void resetStatistics() { // This function sets the operation counters and the comparison histogram back to zero.
+		counters.reset(); // Clear the counters.
+	}
+#endif
+};
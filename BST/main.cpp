@@ -1,33 +1,30 @@
 /*
 This program implements a Binary Search Tree (BST) data structure in C++, providing functions for adding, removing, finding, and traversing nodes. 
-It also includes a performance evaluation component that measures the time taken to add varying numbers of random nodes to the BST, allowing for analysis 
-of the data structure's efficiency as it scales. The implementation demonstrates key BST operations and serves as a foundation for comparing its performance 
-characteristics with other data structures.
+It loads the file named on the command line, prints the tree and runs the test cases. The performance measurements live in the separate Benchmark 
+project, which reports latency percentiles for several key distributions and workloads and can compare a run with an earlier one.
 */
 
 #include <iostream> // This is a header file library that lets us work with input and output objects, such as cout.
 #include <cassert> // This is a header file library that lets us use the assert function to test our code.
 #include <algorithm> // This is a header file library that lets us work with arrays.
-#include <chrono> // This is a header file library that lets us work with time.
 #include <random> // This is a header file library that lets us work with random numbers.
 #include <vector> // This is a header file library that lets us work with arrays that can change in size.
-#include <iomanip> // This is a header file library that lets us work with parametric manipulators.
 #include <fstream> // This is a header file library that lets us work with files.
 #include <filesystem> // This is a header file library that lets us work with file systems.
+#include <cmath> // This is a header file library that lets us use math functions such as log2.
+#include <atomic> // This is a header file library that lets us work with counters that are safe to share between threads.
+#include <sstream> // This is a header file library that lets us read from and write to strings as streams.
+#include <thread> // This is a header file library that lets us run code on several threads.
+#include <stdexcept> // This is a header file library that lets us throw standard exceptions, such as runtime_error.
+#include <cctype> // This is a header file library that lets us work with characters, such as tolower.
 #include "BinarySearchTree.h" // This is a header file that contains the implementation of a binary search tree.
+#include "ConcurrentBinarySearchTree.h" // This is a header file that contains the binary search tree that many threads can use at the same time.
+#include "AllocationCounter.h" // This is a header file that contains the counter of the allocations the program makes.
 
 using namespace std; // using standard namespace to avoid writing std:: before standard library functions
-using namespace chrono; // using chrono namespace to avoid writing chrono:: before time measurement functions
 
 void readFromFile(BinarySearchTree& bst, const string& filename) { // This function reads data from a file and inserts it into the binary search tree.
-	ifstream file(filename); // Open the file for reading.
-	string line; // Create a string to store each line of the file.
-
-	if (file.is_open()) { // Check if the file is open.
-		while (getline(file, line)) { // Read each line from the file.
-			bst.insert(line); // Insert the line into the binary search tree.
-		}
-		file.close(); // Close the file.
+	if (bst.bulkLoadFile(filename)) { // Read the whole file and build a balanced tree from its lines.
 		cout << "Data loaded from file successfully.\n"; // Print a message indicating that the data was loaded successfully.
 	}
 	else { // If the file cannot be opened, print an error message.
@@ -99,26 +96,763 @@ void testVerifyBSTStructure() { // This function tests the structure of the bina
 	cout << "Inorder traversal (should be sorted): " << bst.inorder() << endl; // Print the inorder traversal of the tree.
 }
 
-double measureAddPerformance(int numNodes) { // This function measures the performance of adding nodes to the binary search tree.
-	BinarySearchTree bst; // Create a new binary search tree.
-	random_device rd; // Create a random device to generate random numbers.
-	mt19937 gen(rd()); // Create a random number generator.
-	uniform_int_distribution<> dis(1, 1000000); // Create a uniform distribution for random numbers.
+string makeSortedKey(int value) { // This function turns a number into a zero-padded string, so increasing numbers give increasing strings.
+	string key = to_string(value); // Convert the number to a string.
+	if (key.size() < 8) { // If the string is shorter than eight characters, pad it.
+		key.insert(0, 8 - key.size(), '0'); // Add leading zeros to the string.
+	}
+	return key; // Return the padded string.
+}
+
+void testBalancedTreeHeight() { // This function tests that the balanced modes keep the tree height logarithmic for sorted, reverse-sorted and random input.
+	const int count = 20000; // Define the number of nodes to insert.
+	vector<string> sorted; // Create a vector to store the keys in sorted order.
+	for (int i = 0; i < count; ++i) { // Loop through the number of nodes.
+		sorted.push_back(makeSortedKey(i)); // Add the key to the vector.
+	}
+	vector<string> reversed(sorted.rbegin(), sorted.rend()); // Create a copy of the keys in reverse-sorted order.
+	vector<string> shuffled = sorted; // Create a copy of the keys to shuffle.
+	shuffle(shuffled.begin(), shuffled.end(), mt19937(42)); // Shuffle the keys with a fixed seed.
+	double log2Count = log2(count + 1.0); // Calculate the height of a perfectly balanced tree with the same number of nodes.
+
+	for (BalanceMode mode : { BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balanced modes.
+		double limit = mode == BalanceMode::AVL ? 1.45 * log2Count : 2.0 * log2Count; // An AVL tree is at most 1.45 times and a red-black tree at most 2 times taller than a perfect tree.
+		for (const vector<string>* keys : { &sorted, &reversed, &shuffled }) { // Loop through the input orders.
+			BinarySearchTree bst(mode); // Create a new balanced binary search tree.
+			for (const string& key : *keys) { // Loop through the keys.
+				bst.insert(key); // Insert the key into the tree.
+			}
+			assert(bst.height() <= limit); // Check that the tree height is logarithmic.
+			for (int i = 0; i < count; i += 2) { // Loop through every other key.
+				assert(bst.remove((*keys)[i]) == true); // Remove the key from the tree.
+			}
+			assert(bst.height() <= limit); // Check that the tree height is still logarithmic after removals.
+			for (int i = 0; i < count; ++i) { // Loop through all keys.
+				assert(bst.exists((*keys)[i]) == (i % 2 == 1)); // Check that only the keys that were not removed still exist.
+			}
+		}
+	}
+	cout << "Balanced tree height test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testRemoveRootOnlyNode() { // This function tests removing the only node of the binary search tree in every mode.
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balancing modes.
+		BinarySearchTree bst(mode); // Create a new binary search tree.
+		bst.insert("5"); // Insert a node with value 5.
+		assert(bst.remove("5") == true); // Remove the only node in the tree.
+		assert(bst.exists("5") == false); // Check that the node was removed successfully.
+		assert(bst.inorder().empty()); // Check that the tree is empty.
+	}
+	cout << "Remove root only node test passed.\n"; // Print a message indicating that the test passed.
+}
+
+template <template <typename> class Allocator>
+string buildAndDrain(BalanceMode mode) { // This function inserts and removes keys in a tree that uses the given allocator, and returns what is left.
+	BasicBinarySearchTree<Allocator> bst(mode); // Create a new binary search tree that uses the given allocator.
+	for (int i = 0; i < 1000; ++i) { // Loop through a thousand keys.
+		bst.insert(makeSortedKey(i * 7919 % 1000)); // Insert the keys in a scrambled order.
+	}
+	for (int i = 0; i < 1000; i += 3) { // Loop through every third key.
+		assert(bst.remove(makeSortedKey(i)) == true); // Remove the key, which returns its node to the allocator.
+	}
+	for (int i = 0; i < 1000; i += 3) { // Loop through the removed keys again.
+		bst.insert(makeSortedKey(i)); // Insert the key again, which can reuse a freed node.
+	}
+	assert(bst.remove(makeSortedKey(500)) == true); // Remove one more key.
+	return bst.inorder(); // Return the inorder traversal of the tree.
+}
+
+void testAllocatorsGiveSameTree() { // This function tests that the tree behaves the same with every node allocator.
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balancing modes.
+		string expected = buildAndDrain<NewAllocator>(mode); // Build the tree with nodes allocated by new.
+		assert(buildAndDrain<ArenaAllocator>(mode) == expected); // Check that the arena gives the same tree.
+		assert(buildAndDrain<PoolAllocator>(mode) == expected); // Check that the pool gives the same tree.
+	}
+	cout << "Allocators give same tree test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testKeysSharingPrefix() { // This function tests keys that share their first eight characters, so the comparison has to read the key pool.
+	vector<string> words = { "abcdefgh", "abcdefghi", "abcdefgh" + string(1, '\0'), "abc", "abcdefghij", "abcdefghia", "abcdefgg", "", "zzzzzzzzzzzz" }; // Define keys with shared and tied prefixes.
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new binary search tree.
+	for (const string& word : words) { // Loop through the keys.
+		bst.insert(word); // Insert the key into the tree.
+	}
+	sort(words.begin(), words.end()); // Sort the keys the way std::string orders them.
+	string expected; // Create a string to store the expected inorder traversal.
+	for (const string& word : words) { // Loop through the sorted keys.
+		expected += word + " "; // Append the key to the expected traversal.
+	}
+	assert(bst.inorder() == expected); // Check that the tree orders the keys like std::string does.
+	assert(bst.exists("abcdefghi") == true); // Check that a key longer than the prefix is found.
+	assert(bst.exists("abcdefghk") == false); // Check that a key that only shares the prefix is not found.
+	assert(bst.exists("abcdefg") == false); // Check that a key that is a prefix of another key is not found.
+	cout << "Keys sharing prefix test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testKeyPoolCompaction() { // This function tests that the key pool is rebuilt correctly after many keys are removed.
+	BinarySearchTree bst(BalanceMode::RedBlack); // Create a new binary search tree.
+	for (int i = 0; i < 2000; ++i) { // Loop through two thousand keys.
+		bst.insert("a long key that does not fit in the prefix " + makeSortedKey(i)); // Insert a key that is stored in the key pool.
+	}
+	size_t fullSize = bst.keyBytes(); // Store the size of the key pool before removing keys.
+	for (int i = 0; i < 2000; ++i) { // Loop through the keys.
+		if (i % 10 != 0) { // Keep every tenth key.
+			assert(bst.remove("a long key that does not fit in the prefix " + makeSortedKey(i)) == true); // Remove the key.
+		}
+	}
+	assert(bst.keyBytes() < fullSize / 2); // Check that the key pool was rebuilt and shrank.
+	for (int i = 0; i < 2000; ++i) { // Loop through the keys again.
+		assert(bst.exists("a long key that does not fit in the prefix " + makeSortedKey(i)) == (i % 10 == 0)); // Check that only the kept keys still exist.
+	}
+	cout << "Key pool compaction test passed.\n"; // Print a message indicating that the test passed.
+}
+
+string makeRandomWord(mt19937& gen) { // This function creates a random lowercase word of 3 to 14 letters.
+	uniform_int_distribution<> lengthDis(3, 14); // Create a uniform distribution for the word length.
+	uniform_int_distribution<> letterDis('a', 'z'); // Create a uniform distribution for the letters.
+	string word(lengthDis(gen), ' '); // Create a word with a random length.
+	for (char& letter : word) { // Loop through the letters of the word.
+		letter = static_cast<char>(letterDis(gen)); // Pick a random letter.
+	}
+	return word; // Return the word.
+}
+
+void testConcurrentTreeStress() { // This function tests the concurrent tree with writers and readers running at the same time.
+	ConcurrentBinarySearchTree tree; // Create a new concurrent tree.
+	const int stableCount = 1000; // Define the number of keys that are never removed.
+	const int writerCount = 4; // Define the number of writer threads.
+	const int keysPerWriter = 2000; // Define the number of keys each writer owns.
+	for (int i = 0; i < stableCount; ++i) { // Loop through the stable keys.
+		assert(tree.insert("stable " + makeSortedKey(i)) == true); // Insert the key.
+	}
 
-	auto start = high_resolution_clock::now(); // Start measuring time.
+	atomic<int> writersRunning{ writerCount }; // Create a counter for the writers that have not finished, so the readers know when to stop.
+	vector<thread> threads; // Create a vector to store the threads.
+	for (int writer = 0; writer < writerCount; ++writer) { // Loop through the writers.
+		threads.emplace_back([&tree, &writersRunning, writer]() { // Start a writer. Every writer owns its keys, so it knows which of them must be in the tree.
+			vector<string> keys; // Create a vector to store the keys of the writer.
+			for (int i = 0; i < keysPerWriter; ++i) { // Loop through the keys.
+				keys.push_back(makeSortedKey(i * writerCount + writer)); // Interleave the keys of the writers, so they change the same parts of the tree.
+			}
+			for (int round = 0; round < 3; ++round) { // Fill and drain the tree a few times, so many nodes are replaced and reclaimed.
+				for (const string& key : keys) { // Loop through the keys.
+					assert(tree.insert(key) == true); // Insert the key, which no other thread can have inserted.
+					assert(tree.exists(key) == true); // Check that the key is visible right away.
+				}
+				for (size_t i = 0; i < keys.size(); ++i) { // Loop through the keys.
+					if (round < 2 || i % 2 == 1) { // Remove every key, except for the even keys in the last round.
+						assert(tree.remove(keys[i]) == true); // Remove the key.
+						assert(tree.exists(keys[i]) == false); // Check that the key is gone right away.
+					}
+				}
+			}
+			writersRunning.fetch_sub(1); // Tell the readers that this writer is done.
+		});
+	}
+	for (int reader = 0; reader < 2; ++reader) { // Start two readers.
+		threads.emplace_back([&tree, &writersRunning, reader]() { // Start a reader, which checks what every version of the tree must look like.
+			mt19937 gen(reader); // Create a random number generator with a fixed seed.
+			uniform_int_distribution<> dis(0, stableCount - 1); // Create a distribution over the stable keys.
+			while (writersRunning.load() > 0) { // Loop until every writer is done.
+				assert(tree.exists("stable " + makeSortedKey(dis(gen))) == true); // Check that a stable key is always found.
+				string previous; // Create a string to store the previous key of the scan.
+				int stableSeen = 0; // Create a counter for the stable keys the scan visits.
+				bool first = true; // Create a flag for the first key of the scan.
+				tree.forEach([&](string_view key) { // Scan one version of the tree.
+					assert(first || previous < key); // Check that the keys are strictly increasing.
+					stableSeen += key.substr(0, 7) == "stable " ? 1 : 0; // Count the stable keys.
+					previous = string(key); // Remember the key.
+					first = false; // The next key is not the first.
+				});
+				assert(stableSeen == stableCount); // Check that every version holds all stable keys.
+			}
+		});
+	}
+	for (thread& worker : threads) { // Loop through the threads.
+		worker.join(); // Wait for the thread to finish.
+	}
 
-	for (int i = 0; i < numNodes; ++i) { // Loop through the specified number of nodes.
-		bst.insert(to_string(dis(gen))); // Insert a random node into the tree.
-    }
+	assert(tree.size() == stableCount + writerCount * keysPerWriter / 2); // Check that the stable keys and the even keys of the last round are left.
+	for (int i = 0; i < writerCount * keysPerWriter; ++i) { // Loop through the keys of all writers.
+		assert(tree.exists(makeSortedKey(i)) == ((i / writerCount) % 2 == 0)); // Check that exactly the even keys of every writer are left.
+	}
+	assert(tree.height() <= 1.45 * log2(tree.size() + 2.0)); // Check that the tree stayed balanced.
+	size_t pending = tree.pendingReclaim(); // Get the number of replaced nodes the writers left behind.
+	tree.reclaim(); // Delete them, now that the threads that retired them have ended and nobody is reading.
+	assert(tree.pendingReclaim() == 0); // Check that nothing is left waiting.
 
-	auto end = high_resolution_clock::now(); // Stop measuring time.
-	duration<double> diff = end - start; // Calculate the time taken to add the nodes.
-	return diff.count(); // Return the time taken in seconds.
+	const int crowdSize = 3 * static_cast<int>(EpochReclaimer::slotsPerBlock); // Define a number of threads that need more than one block of reclaimer slots.
+	atomic<int> started{ 0 }; // Create a counter for the threads that hold a slot.
+	vector<thread> crowd; // Create a vector to store the threads.
+	for (int i = 0; i < crowdSize; ++i) { // Loop through the threads.
+		crowd.emplace_back([&tree, &started, i]() { // Start a thread that reads and writes while all the others hold their slots too.
+			assert(tree.exists("stable " + makeSortedKey(i % stableCount)) == true); // Look up a stable key. The first lookup claims a slot for the thread, and must not fail.
+			started.fetch_add(1); // Report that the thread holds a slot.
+			while (started.load() < crowdSize) { // Wait until every thread holds a slot, so they are all taken at once.
+				this_thread::yield(); // Let the other threads start.
+			}
+			string key = "crowd " + makeSortedKey(i); // Create a key only this thread uses.
+			assert(tree.insert(key) == true); // Insert the key.
+			assert(tree.remove(key) == true); // Remove it again, so replaced nodes are retired from slots in the added blocks too.
+		});
+	}
+	for (thread& worker : crowd) { // Loop through the threads.
+		worker.join(); // Wait for the thread to finish.
+	}
+	assert(tree.size() == stableCount + writerCount * keysPerWriter / 2); // Check that the crowd left the tree as it was.
+	tree.reclaim(); // Delete the nodes the crowd replaced, including the ones in the added blocks.
+	assert(tree.pendingReclaim() == 0); // Check that nothing is left waiting.
+	cout << "Concurrent tree stress test passed (" << pending << " objects reclaimed after the threads ended).\n"; // Print a message indicating that the test passed.
 }
 
-int main() { // This is the main function where the program starts.
+void testFrozenTreeMatchesExists() { // This function tests that the frozen snapshot gives the same answers as the tree it was built from.
+	for (int count = 0; count <= 40; ++count) { // Loop through small tree sizes, so every shape of the Eytzinger layout is covered.
+		BinarySearchTree bst(BalanceMode::RedBlack); // Create a new binary search tree.
+		for (int i = 0; i < count; ++i) { // Loop through the keys.
+			bst.insert(makeSortedKey(i * 2)); // Insert only the even numbers, so the odd numbers fall between keys.
+		}
+		FrozenBinarySearchTree frozen = bst.freeze(); // Build the snapshot.
+		assert(frozen.size() == bst.size()); // Check that the snapshot has every key.
+		for (int i = -1; i <= count * 2 + 1; ++i) { // Loop through the keys, the gaps between them and both ends.
+			assert(frozen.exists(makeSortedKey(i)) == bst.exists(makeSortedKey(i))); // Check that both give the same answer.
+		}
+	}
+
+	mt19937 gen(3); // Create a random number generator with a fixed seed.
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new binary search tree.
+	vector<string> words; // Create a vector to store the words.
+	for (int i = 0; i < 20000; ++i) { // Loop through twenty thousand words.
+		words.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+		bst.insert(words.back()); // Insert the word into the tree.
+		bst.insert(words.back() + "-with-a-long-shared-tail"); // Insert a longer word with the same prefix.
+	}
+	for (int i = 0; i < 20000; i += 4) { // Loop through every fourth word.
+		bst.remove(words[i]); // Remove the word, so the snapshot is built from a tree that has changed.
+	}
+	FrozenBinarySearchTree frozen = bst.freeze(); // Build the snapshot.
+	for (int i = 0; i < 20000; ++i) { // Loop through the words.
+		assert(frozen.exists(words[i]) == bst.exists(words[i])); // Check the word itself.
+		assert(frozen.exists(words[i] + "-with-a-long-shared-tail") == true); // Check the longer word, which was never removed.
+		assert(frozen.exists(words[i] + "-with-a-long-shared-tai") == false); // Check a missing word that shares most of the longer word.
+	}
+	cout << "Frozen tree matches exists test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testBulkLoad() { // This function tests building a balanced tree from a range of words in every mode.
+	const int count = 5000; // Define the number of distinct keys.
+	vector<string> keys; // Create a vector to store the keys.
+	for (int i = 0; i < count; ++i) { // Loop through the keys.
+		keys.push_back(makeSortedKey(i)); // Add the key to the vector.
+	}
+	vector<string> shuffled = keys; // Create a copy of the keys to shuffle.
+	shuffled.insert(shuffled.end(), keys.begin(), keys.begin() + 100); // Add some duplicates, which must be ignored.
+	shuffle(shuffled.begin(), shuffled.end(), mt19937(5)); // Shuffle the keys with a fixed seed.
+	string expected; // Create a string to store the expected inorder traversal.
+	for (const string& key : keys) { // Loop through the sorted keys.
+		expected += key + " "; // Append the key to the expected traversal.
+	}
+
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balancing modes.
+		for (const vector<string>* input : { &keys, &shuffled }) { // Loop through sorted and shuffled input.
+			BinarySearchTree bst(mode); // Create a new binary search tree.
+			bst.insert("old word"); // Insert a word that the bulk load must replace.
+			bst.bulkLoad(input->begin(), input->end()); // Build the tree from the keys.
+			assert(bst.inorder() == expected); // Check that the tree holds every key once, in order.
+			assert(bst.size() == keys.size()); // Check the number of keys.
+			assert(bst.exists("old word") == false); // Check that the old contents were replaced.
+			double limit = mode == BalanceMode::RedBlack ? 2.0 * log2(count + 1.0) : ceil(log2(count + 1.0)); // A bulk-built tree is perfectly balanced, or within the red-black bound.
+			assert(bst.height() <= limit); // Check the height of the tree.
+
+			vector<string> order = keys; // Create a copy of the keys to remove in random order.
+			shuffle(order.begin(), order.end(), mt19937(9)); // Shuffle the keys with a fixed seed.
+			for (int i = 0; i < count; ++i) { // Loop through the keys. Removing every key checks that the bulk-built tree keeps the invariants of its mode.
+				assert(bst.remove(order[i]) == true); // Remove the key.
+				if (i % 500 == 0) { // Check the tree from time to time.
+					assert(bst.exists(order[i]) == false); // Check that the key is gone.
+					assert(bst.height() <= 2.0 * log2(count + 1.0) || mode == BalanceMode::None); // Check that balanced trees stay balanced.
+				}
+			}
+			assert(bst.size() == 0 && bst.inorder().empty()); // Check that the tree is empty.
+		}
+	}
+	cout << "Bulk load test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testInsertMany() { // This function tests merging batches of words into an existing tree.
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balancing modes.
+		BinarySearchTree bst(mode); // Create a new binary search tree.
+		vector<string> expected; // Create a vector to store the keys that should be in the tree.
+		for (int i = 0; i < 3000; i += 3) { // Loop through every third number.
+			bst.insert(makeSortedKey(i)); // Insert the key one at a time.
+			expected.push_back(makeSortedKey(i)); // Remember the key.
+		}
+		vector<string> largeBatch; // Create a large batch, which is merged by rebuilding the tree.
+		for (int i = 2999; i >= 0; i -= 2) { // Loop through every second number, backwards.
+			largeBatch.push_back(makeSortedKey(i)); // Add the key to the batch.
+		}
+		bst.insertMany(largeBatch.begin(), largeBatch.end()); // Merge the batch into the tree.
+		vector<string> smallBatch = { makeSortedKey(4), makeSortedKey(8), makeSortedKey(3) }; // Create a small batch, which is inserted one key at a time.
+		bst.insertMany(smallBatch.begin(), smallBatch.end()); // Insert the batch into the tree.
+
+		expected.insert(expected.end(), largeBatch.begin(), largeBatch.end()); // Add the large batch to the expected keys.
+		expected.insert(expected.end(), smallBatch.begin(), smallBatch.end()); // Add the small batch to the expected keys.
+		sort(expected.begin(), expected.end()); // Sort the expected keys.
+		expected.erase(unique(expected.begin(), expected.end()), expected.end()); // Remove duplicates from the expected keys.
+		string traversal; // Create a string to store the expected inorder traversal.
+		for (const string& key : expected) { // Loop through the expected keys.
+			traversal += key + " "; // Append the key to the expected traversal.
+		}
+		assert(bst.inorder() == traversal); // Check that the tree holds the union of all batches.
+		assert(bst.size() == expected.size()); // Check the number of keys.
+		assert(bst.remove(makeSortedKey(3)) == true && bst.exists(makeSortedKey(3)) == false); // Check that the merged tree still supports removal.
+	}
+	cout << "Insert many test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testBulkLoadFile() { // This function tests loading a tree from a file with Windows line endings and no final newline.
+	string filename = (filesystem::temp_directory_path() / "bst_bulk_load_test.txt").string(); // Create a path for a temporary file.
+	{
+		ofstream file(filename, ios::binary); // Open the file for writing, without any newline translation.
+		file << "pear\r\napple\r\n\r\nfig\napple\nbanana"; // Write lines with mixed endings, an empty line, a duplicate and no final newline.
+	}
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new binary search tree.
+	assert(bst.bulkLoadFile(filename) == true); // Load the file.
+	assert(bst.inorder() == " apple banana fig pear "); // Check that every line was loaded once, without carriage returns.
+	filesystem::remove(filename); // Delete the temporary file.
+	assert(bst.bulkLoadFile(filename) == false); // Check that a missing file is reported.
+	{
+		ofstream file(filename, ios::binary); // Create an empty file, which cannot be mapped but is still a valid input.
+	}
+	assert(bst.bulkLoadFile(filename) == true && bst.size() == 0); // Check that an empty file gives an empty tree.
+	filesystem::remove(filename); // Delete the temporary file.
+	cout << "Bulk load file test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testIterators() { // This function tests walking the tree with iterators and finding bounds, against a sorted vector of the same keys.
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balancing modes, which give different shapes.
+		mt19937 gen(19); // Create a random number generator with a fixed seed.
+		BinarySearchTree bst(mode); // Create a new binary search tree.
+		vector<string> keys; // Create a vector to store the keys.
+		for (int i = 0; i < 3000; ++i) { // Loop through three thousand words.
+			keys.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+			bst.insert(keys.back()); // Insert the word into the tree.
+		}
+		sort(keys.begin(), keys.end()); // Sort the keys.
+		keys.erase(unique(keys.begin(), keys.end()), keys.end()); // Remove duplicates from the keys.
+
+		assert(equal(bst.begin(), bst.end(), keys.begin(), keys.end())); // Check that a forward walk gives the keys in sorted order.
+		vector<string_view> backward; // Create a vector to store the keys of a backward walk.
+		for (auto it = bst.end(); it != bst.begin(); ) { // Walk from the end back to the first key.
+			backward.push_back(*--it); // Move back and store the key.
+		}
+		assert(equal(backward.rbegin(), backward.rend(), keys.begin(), keys.end())); // Check that the backward walk gives the keys in reverse order.
+		assert(static_cast<size_t>(distance(bst.begin(), bst.end())) == bst.size()); // Check that the iterators work with standard algorithms.
+
+		for (int i = 0; i < 2000; ++i) { // Loop through probes, half of which are in the tree.
+			string probe = i % 2 == 0 ? keys[gen() % keys.size()] : makeRandomWord(gen); // Pick a key or a random word.
+			auto lower = std::lower_bound(keys.begin(), keys.end(), probe); // Find the expected lower bound.
+			auto upper = std::upper_bound(keys.begin(), keys.end(), probe); // Find the expected upper bound.
+			auto treeLower = bst.lower_bound(probe); // Find the lower bound in the tree.
+			auto treeUpper = bst.upper_bound(probe); // Find the upper bound in the tree.
+			assert((treeLower == bst.end()) == (lower == keys.end()) && (treeLower == bst.end() || *treeLower == *lower)); // Check the lower bound.
+			assert((treeUpper == bst.end()) == (upper == keys.end()) && (treeUpper == bst.end() || *treeUpper == *upper)); // Check the upper bound.
+			assert((bst.find(probe) != bst.end()) == bst.exists(probe)); // Check that find agrees with exists.
+			if (treeLower != bst.begin()) { // If there is a smaller key, the iterator must be able to step back to it.
+				assert(*prev(treeLower) == *prev(lower)); // Check the step back from the lower bound.
+			}
+		}
+		assert(bst.lower_bound("") == bst.begin() && bst.upper_bound("zzzzzzzzzzzzzzzz") == bst.end()); // Check bounds outside the keys.
+	}
+	BinarySearchTree empty; // Create an empty tree.
+	assert(empty.begin() == empty.end() && empty.lower_bound("a") == empty.end()); // Check the iterators of an empty tree.
+	cout << "Iterators test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testRangeAndTraversals() { // This function tests range queries, visitor traversals and streaming, including on a tree that is one long path.
+	BinarySearchTree bst; // Create a new unbalanced binary search tree.
+	vector<string> keys = { "5", "3", "7", "2", "4", "6", "8" }; // Define keys that give a known shape.
+	for (const string& key : keys) { // Loop through the keys.
+		bst.insert(key); // Insert the key into the tree.
+	}
+	assert(bst.inorder() == "2 3 4 5 6 7 8 "); // Check the inorder traversal.
+	assert(bst.preorder() == "5 3 2 4 7 6 8 "); // Check the preorder traversal.
+	assert(bst.postorder() == "2 4 3 6 8 7 5 "); // Check the postorder traversal.
+	stringstream stream; // Create a stream to write the traversal to.
+	bst.write(stream, TraversalOrder::Postorder, ','); // Stream the postorder traversal with a different separator.
+	assert(stream.str() == "2,4,3,6,8,7,5,"); // Check the streamed traversal.
+
+	string visited; // Create a string to store the keys a range query visits.
+	bst.range("3", "6", [&visited](string_view key) { visited += key; }); // Visit the keys from 3 to 6.
+	assert(visited == "3456"); // Check that both ends are included.
+	visited.clear(); // Forget the visited keys.
+	bst.range("35", "55", [&visited](string_view key) { visited += key; }); // Visit a range whose ends are not keys.
+	assert(visited == "45"); // Check the keys between the ends.
+	visited.clear(); // Forget the visited keys.
+	bst.range("9", "99", [&visited](string_view key) { visited += key; }); // Visit a range above every key.
+	bst.range("6", "3", [&visited](string_view key) { visited += key; }); // Visit a range whose ends are swapped.
+	assert(visited.empty()); // Check that neither range visits anything.
+
+	BinarySearchTree chain; // Create an unbalanced tree that becomes one long path.
+	const int count = 10000; // Define the number of keys.
+	for (int i = 0; i < count; ++i) { // Loop through increasing keys.
+		chain.insert(makeSortedKey(i)); // Insert the key, which becomes the right child of the previous one.
+	}
+	int visits = 0; // Create a counter for the visited keys.
+	string previous; // Create a string to store the previous key.
+	chain.forEach(TraversalOrder::Postorder, [&](string_view key) { // Visit the keys from the bottom of the path up.
+		assert(visits == 0 || key < previous); // Check that the keys come in reverse order.
+		previous = string(key); // Remember the key.
+		++visits; // Count the key.
+	});
+	assert(visits == count && chain.preorder() == chain.inorder()); // Check that every key was visited, and that preorder follows the path in order.
+	int inRange = 0; // Create a counter for the keys in a range.
+	chain.range(makeSortedKey(count - 10), makeSortedKey(2 * count), [&inRange](string_view) { ++inRange; }); // Visit the last keys of the path.
+	assert(inRange == 10); // Check the number of keys in the range.
+	assert(chain.remove(makeSortedKey(count - 1)) && chain.remove(makeSortedKey(count / 2)) && chain.size() == size_t(count - 2)); // Remove the deepest key and one in the middle of the path.
+	cout << "Range and traversals test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testStreamRoundTrip() { // This function tests writing a tree to a stream and reading it back.
+	mt19937 gen(11); // Create a random number generator with a fixed seed.
+	BinarySearchTree bst(BalanceMode::RedBlack); // Create a new binary search tree.
+	for (int i = 0; i < 2000; ++i) { // Loop through two thousand words.
+		bst.insert(makeRandomWord(gen)); // Insert a random word into the tree.
+	}
+	bst.insert("a word with spaces"); // Insert a word with spaces, which must survive the round trip as one key.
+	stringstream stream; // Create a stream to write the tree to.
+	stream << bst; // Write the tree to the stream.
+	BinarySearchTree copy(BalanceMode::AVL); // Create a second tree with a different balancing mode.
+	copy.insert("old word"); // Insert a word that reading the stream must replace.
+	stream >> copy; // Read the tree back from the stream.
+	assert(!stream.bad() && stream.eof()); // Check that the whole stream was read without an error.
+	assert(copy.inorder() == bst.inorder()); // Check that the second tree holds the same keys.
+	assert(copy.size() == bst.size()); // Check the number of keys.
+	assert(copy.exists("a word with spaces") == true); // Check that the word with spaces is one key.
+	cout << "Stream round trip test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testSnapshotFile() { // This function tests saving a snapshot to a file and mapping it back.
+	string filename = (filesystem::temp_directory_path() / "bst_snapshot_test.bin").string(); // Create a path for a temporary file.
+	mt19937 gen(13); // Create a random number generator with a fixed seed.
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new binary search tree.
+	vector<string> words; // Create a vector to store the words.
+	for (int i = 0; i < 5000; ++i) { // Loop through five thousand words.
+		words.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+		if (i % 3 != 0) { // Leave every third word out, so some lookups miss.
+			bst.insert(words.back()); // Insert the word into the tree.
+		}
+	}
+	assert(bst.saveSnapshot(filename) == true); // Save the snapshot.
+
+	FrozenBinarySearchTree mapped; // Create an empty snapshot.
+	assert(mapped.open(filename) == true); // Map the saved snapshot.
+	assert(mapped.size() == bst.size()); // Check the number of keys.
+	for (const string& word : words) { // Loop through the words.
+		assert(mapped.exists(word) == bst.exists(word)); // Check that the mapped snapshot gives the same answer as the tree.
+	}
+	BinarySearchTree loaded(BalanceMode::RedBlack); // Create a tree to load the snapshot into.
+	assert(loaded.loadSnapshot(filename) == true); // Load the snapshot.
+	assert(loaded.inorder() == bst.inorder()); // Check that the loaded tree holds the same keys.
+
+	string damagedFile = filename + ".damaged"; // Create a path for a copy of the snapshot with one damaged entry.
+	filesystem::copy_file(filename, damagedFile, filesystem::copy_options::overwrite_existing); // Copy the snapshot.
+	{
+		fstream file(damagedFile, ios::binary | ios::in | ios::out); // Open the copy for changing it in place.
+		uint64_t location = uint64_t(1) << 39; // Create a location far past the end of the key characters, which leaves the header consistent.
+		file.seekp(sizeof(FrozenFileHeader) + 3 * sizeof(FrozenEntry) + sizeof(uint64_t)); // Move to the location of the third entry.
+		file.write(reinterpret_cast<const char*>(&location), sizeof(location)); // Overwrite it.
+	}
+	FrozenBinarySearchTree damaged; // Create an empty snapshot.
+	assert(damaged.open(damagedFile) == false && damaged.size() == 0); // Check that the damaged file is rejected instead of being read out of bounds.
+	assert(loaded.loadSnapshot(damagedFile) == false); // Check that the tree rejects it too.
+	filesystem::remove(damagedFile); // Delete the damaged file.
+
+	BinarySearchTree empty; // Create an empty tree.
+#ifdef _WIN32
+	assert(empty.saveSnapshot(filename) == false); // Windows does not replace a file that is still mapped, so the save fails and the file stays as it was.
+#else
+	assert(empty.saveSnapshot(filename) == true); // Overwrite the file with an empty snapshot.
+	assert(loaded.loadSnapshot(filename) == true && loaded.size() == 0); // Check that an empty snapshot loads as an empty tree.
+#endif
+
+	assert(mapped.exists(words[1]) == true); // Check that the snapshot that was already open still reads the file it mapped.
+	string textFile = filename + ".txt"; // Create a path for a file that is not a snapshot.
+	{
+		ofstream file(textFile, ios::binary); // Open the file for writing.
+		file << "pear\napple\n"; // Write a few lines, which are not a snapshot.
+	}
+	assert(mapped.open(textFile) == false); // Check that the text file is rejected.
+	assert(mapped.exists(words[1]) == true); // Check that the snapshot that was already open is still usable.
+	assert(loaded.loadSnapshot(textFile) == false); // Check that the tree rejects the text file too.
+	filesystem::remove(textFile); // Delete the text file.
+	filesystem::remove(filename); // Delete the snapshot file.
+	assert(mapped.open(filename) == false); // Check that a missing file is reported.
+	cout << "Snapshot file test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testParallelOperations() { // This function tests the copy, comparison, set operations and folds that run on a task pool, against the same operations on sorted vectors.
+	TaskPool tasks(4); // Create a pool with four threads, so the parallel paths run even on a machine with fewer cores.
+	bool caught = false; // Create a flag to store whether the exception arrived.
+	try { // Throw from the function that may run on another thread.
+		tasks.invoke([]() {}, []() { throw runtime_error("task failed"); }); // Run a task that throws.
+	}
+	catch (const runtime_error&) { // The exception must reach the caller.
+		caught = true; // Remember that the exception arrived.
+	}
+	assert(caught); // Check that the exception was passed on.
+
+	atomic<int> callersInside{ 0 }; // Create a counter for the outside threads that are inside invoke.
+	auto meet = [&tasks, &callersInside]() { // Create a function that only returns once three outside threads are inside invoke at the same time.
+		tasks.invoke([&callersInside]() { // Run the waiting part on the calling thread.
+			callersInside.fetch_add(1); // Report that this caller is inside.
+			while (callersInside.load() < 3) { // Wait for the other callers, which would wait forever if outside threads had to take turns.
+				this_thread::yield(); // Let the other threads run.
+			}
+		}, []() {}); // Offer an empty task, which any thread may steal.
+		atomic<size_t> sum{ 0 }; // Create a sum that the pool's threads add to while the other callers split their work too.
+		tasks.parallelFor(0, 100000, 100, [&sum](size_t i) { sum.fetch_add(i, memory_order_relaxed); }); // Add up the numbers, so tasks are stolen from every caller's queue.
+		assert(sum.load() == size_t(100000) * 99999 / 2); // Check that every number was added exactly once.
+	};
+	thread secondCaller(meet); // Start a second outside thread.
+	thread thirdCaller(meet); // Start a third outside thread.
+	meet(); // Call from this thread too.
+	secondCaller.join(); // Wait for the second thread.
+	thirdCaller.join(); // Wait for the third thread.
+
+	const int count = 60000; // Define the number of keys, which is large enough to split the work into tasks.
+	vector<string> firstKeys; // Create a vector to store the keys of the first tree.
+	vector<string> secondKeys; // Create a vector to store the keys of the second tree.
+	for (int i = 0; i < count; ++i) { // Loop through the keys.
+		firstKeys.push_back(makeSortedKey(i * 2)); // The first tree holds the even numbers.
+		secondKeys.push_back(makeSortedKey(i * 3)); // The second tree holds the multiples of three, so the trees overlap.
+	}
+	vector<string> unionKeys, intersectionKeys, differenceKeys; // Create vectors to store the expected results.
+	set_union(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(), back_inserter(unionKeys)); // Calculate the expected union.
+	set_intersection(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(), back_inserter(intersectionKeys)); // Calculate the expected intersection.
+	set_difference(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(), back_inserter(differenceKeys)); // Calculate the expected difference.
+	auto matches = [](const BinarySearchTree& bst, const vector<string>& keys) { // Create a function that checks if the tree holds exactly the keys.
+		return bst.size() == keys.size() && equal(bst.begin(), bst.end(), keys.begin()); // Compare the sizes and the keys.
+	};
+
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Loop through the balancing modes.
+		BinarySearchTree first(mode); // Create the first tree.
+		BinarySearchTree second(mode); // Create the second tree.
+		vector<string> shuffled = firstKeys; // Create a copy of the keys to shuffle, so an unbalanced tree is not one long path.
+		shuffle(shuffled.begin(), shuffled.end(), mt19937(3)); // Shuffle the keys with a fixed seed.
+		for (const string& key : shuffled) { // Loop through the keys.
+			first.insert(key); // Insert the key one at a time, so the tree has an irregular shape.
+		}
+		second.bulkLoad(secondKeys.begin(), secondKeys.end()); // Build the second tree.
+		double limit = mode == BalanceMode::RedBlack ? 2.0 * log2(2.0 * count + 1.0) : ceil(log2(2.0 * count + 1.0)); // Every tree built from sorted keys is perfectly balanced, or within the red-black bound.
+
+		BinarySearchTree copy(first); // Copy the first tree.
+		assert(copy == first && !(copy != first)); // Check that the copy holds the same keys.
+		assert(matches(copy, firstKeys) && copy.balanceMode() == mode); // Check the keys and the mode of the copy.
+		assert(copy.preorder() == first.preorder() && copy.height() == first.height()); // Check that the copy has the same shape, which for an unbalanced tree is not a balanced one.
+		assert(copy.remove(firstKeys[count / 2]) && copy != first && first.exists(firstKeys[count / 2])); // Check that the copy is independent of the original.
+		copy.insert("zzz"); // Make the sizes equal again with a different key.
+		assert(copy.size() == first.size() && copy != first); // Check that trees of equal size with different keys differ.
+		copy = second; // Assign the second tree to the copy.
+		assert(copy == second && matches(copy, secondKeys) && copy.postorder() == second.postorder()); // Check the assigned copy and its shape.
+
+		BinarySearchTree result(mode); // Create a tree to store the results.
+		result.insert("old word"); // Insert a word that the set operations must replace.
+		result.assignUnion(first, second, tasks); // Calculate the union.
+		assert(matches(result, unionKeys) && result.height() <= limit); // Check the union and its shape.
+		result.assignIntersection(first, second, tasks); // Calculate the intersection, reusing the nodes of the union.
+		assert(matches(result, intersectionKeys) && result.height() <= limit); // Check the intersection and its shape.
+		result.assignDifference(first, second, tasks); // Calculate the difference.
+		assert(matches(result, differenceKeys) && result.height() <= limit); // Check the difference and its shape.
+		result.assignDifference(second, second); // Calculate the difference of a tree with itself on the shared pool.
+		assert(result.size() == 0 && result.begin() == result.end()); // Check that the result is empty.
+		copy.assign(first, tasks); // Copy the first tree again.
+		copy.assignUnion(copy, second, tasks); // Calculate the union into one of its inputs.
+		assert(matches(copy, unionKeys)); // Check the union.
+		for (int i = 0; i < count; i += 7) { // Loop through some of the keys. Changing a tree built on the pool checks that it keeps the invariants of its mode.
+			assert(copy.remove(firstKeys[i])); // Remove a key.
+			copy.insert(firstKeys[i] + "x"); // Insert a key next to it.
+		}
+		assert(mode == BalanceMode::None || copy.height() <= 2.0 * log2(3.0 * count)); // Check that a balanced tree stays balanced.
+
+		size_t evenLast = first.countIf([](string_view key) { return (key.back() - '0') % 4 == 0; }, tasks); // Count the keys whose last digit is a multiple of four.
+		assert(evenLast == static_cast<size_t>(count_if(firstKeys.begin(), firstKeys.end(), [](const string& key) { return (key.back() - '0') % 4 == 0; }))); // Compare with counting the vector.
+		size_t characters = first.fold(size_t(0), [](string_view key) { return key.size(); }, [](size_t left, size_t right) { return left + right; }, tasks); // Add up the key lengths.
+		assert(characters == firstKeys.size() * 8); // Every key has eight characters.
+		string joined = first.fold(string(), [](string_view key) { return string(key) + " "; }, [](string left, const string& right) { left += right; return left; }, tasks); // Join the keys, which only works if the fold keeps sorted order.
+		assert(joined == first.inorder()); // Compare with the inorder traversal.
+	}
+
+	BinarySearchTree empty; // Create an empty tree.
+	BinarySearchTree emptyCopy(empty); // Copy the empty tree.
+	assert(emptyCopy == empty && emptyCopy.size() == 0 && empty.countIf([](string_view) { return true; }) == 0); // Check the empty copy and fold.
+	cout << "Parallel operations test passed.\n"; // Print a message indicating that the test passed.
+}
+
+void testTypedTrees() { // This function tests the typed tree as a set of integers, in both orders, and as a map, in every mode.
+	static_assert(is_same<BinarySearchTree, BasicBinarySearchTree<PoolAllocator>>::value, "The default tree must stay the string tree."); // Check that strings still use the key pool tree.
+	static_assert(TypedBinarySearchTree<uint64_t, greater<uint64_t>>::integralKeys && !TypedBinarySearchTree<string, less<string>, int>::integralKeys, "Only integers take the fast path."); // Check which trees take the integer fast path.
+	assert(sizeof(void*) != 8 || sizeof(TypedNode<int, void>) == 24); // Check that a set of 32-bit keys packs its node into 24 bytes on 64-bit systems.
+
+	for (BalanceMode mode : { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }) { // Test every balancing mode.
+		TypedBinarySearchTree<int> ids(mode); // Create a set of integers.
+		for (int i = 0; i < 1000; ++i) { // Loop through a thousand keys.
+			assert(ids.insert(i * 7919 % 1000) == true); // Insert the keys in a scrambled order.
+		}
+		assert(ids.insert(500) == false && ids.size() == 1000); // Check that a duplicate is not inserted.
+		for (int i = 0; i < 1000; i += 2) { // Loop through the even keys.
+			assert(ids.remove(i) == true); // Remove the key.
+		}
+		assert(ids.remove(0) == false && ids.remove(5000) == false && ids.size() == 500); // Check that missing keys are not removed.
+		vector<int> keys; // Create a vector to store the keys in sorted order.
+		ids.forEach([&keys](int key) { keys.push_back(key); }); // Visit the keys.
+		assert(keys.size() == 500 && keys.front() == 1 && keys.back() == 999 && is_sorted(keys.begin(), keys.end())); // Check that the odd keys are left in sorted order.
+		assert(ids.exists(501) == true && ids.exists(502) == false && ids.exists(-1) == false); // Check lookups.
+		if (mode != BalanceMode::None) { // The balanced modes keep the tree short.
+			assert(ids.height() <= 2 * log2(501)); // Check that the height is logarithmic.
+		}
+		vector<int> inRange; // Create a vector to store the keys of a range.
+		ids.range(10, 20, [&inRange](int key) { inRange.push_back(key); }); // Visit the keys from 10 to 20.
+		assert((inRange == vector<int>{ 11, 13, 15, 17, 19 })); // Check the range.
+
+		TypedBinarySearchTree<int> copy(ids); // Copy the set.
+		assert(copy.remove(1) == true && copy.size() == 499 && ids.exists(1) == true && copy.height() == ids.height()); // Check that the copy has the same shape and is independent.
+		copy = ids; // Assign the set again.
+		assert(copy.exists(1) == true && copy.size() == 500); // Check that the assignment copied every key.
+		copy.clear(); // Remove every key.
+		assert(copy.empty() && copy.height() == 0 && ids.size() == 500); // Check that clearing the copy left the set alone.
+
+		TypedBinarySearchTree<uint64_t, greater<uint64_t>, void, NewAllocator> descending(mode); // Create a set of 64-bit integers in descending order that allocates every node with new.
+		for (uint64_t id : { 5ULL, 1ULL, 9ULL, 3ULL, 1ULL << 40 }) { // Loop through some IDs, one of them larger than 32 bits.
+			descending.insert(id); // Insert the ID.
+		}
+		vector<uint64_t> order; // Create a vector to store the IDs in the order of the tree.
+		descending.forEach([&order](uint64_t id) { order.push_back(id); }); // Visit the IDs.
+		assert((order == vector<uint64_t>{ 1ULL << 40, 9, 5, 3, 1 })); // Check that the largest ID comes first.
+		assert(descending.remove(9) == true && descending.exists(9) == false && descending.exists(5) == true); // Check removal in descending order.
+
+		TypedBinarySearchTree<string, less<string>, int> counts(mode); // Create a map from words to counts.
+		for (const char* word : { "pear", "apple", "fig", "apple", "kiwi", "apple", "fig" }) { // Loop through some words with repeats.
+			++counts[word]; // Count the word.
+		}
+		assert(counts.size() == 4 && *counts.lookup("apple") == 3 && *counts.lookup("fig") == 2 && counts.lookup("plum") == nullptr); // Check the counts.
+		assert(counts.insert("pear", 10) == false && *counts.lookup("pear") == 1); // Check that insert keeps the old value.
+		assert(counts.insertOrAssign("pear", 10) == false && *counts.lookup("pear") == 10); // Check that insertOrAssign replaces it.
+		assert(counts.insert("plum", 7) == true && counts.remove("apple") == true && counts.exists("apple") == false); // Insert a new word and remove one.
+		string joined; // Create a string to store the map in sorted order.
+		counts.forEach([&joined](const string& word, int count) { joined += word + "=" + to_string(count) + " "; }); // Visit the words and their counts.
+		assert(joined == "fig=2 kiwi=1 pear=10 plum=7 "); // Check the map.
+		const auto& constCounts = counts; // Create a read-only view of the map.
+		assert(*constCounts.lookup("plum") == 7); // Check a lookup through the read-only view.
+	}
+
+	struct CaseInsensitive { // This struct orders words without regard to case.
+		bool operator()(const string& a, const string& b) const { // This function checks if the first word comes before the second.
+			return lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) { return tolower(x) < tolower(y); }); // Compare the lowercase letters.
+		}
+	};
+	TypedBinarySearchTree<string, CaseInsensitive> words(BalanceMode::AVL); // Create a set that ignores case.
+	assert(words.insert("Hello") == true && words.insert("HELLO") == false && words.exists("hello") == true); // Check that words differing only in case are the same key.
+
+	TypedBinarySearchTree<int> chain; // Create an unbalanced set that becomes one long path.
+	const int count = 100000; // Define the number of keys, far more than the stack could hold as recursive calls.
+	for (int i = 0; i < count; ++i) { // Loop through increasing keys.
+		chain.insert(i); // Insert the key, which becomes the right child of the previous one.
+	}
+	assert(chain.height() == count && chain.remove(count - 1) && chain.remove(count / 2) && chain.size() == size_t(count - 2)); // Check the path, and remove the deepest key and one in the middle.
+	cout << "Typed trees test passed.\n"; // Print a message indicating that the test passed.
+}
+
+#ifdef BST_ENABLE_STATS
+void testStatistics() { // This function tests the operation counters, the comparison histogram, the shape and the memory the tree reports when statistics are enabled.
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new binary search tree.
+	for (int i = 0; i < 1000; ++i) { // Loop through a thousand keys in sorted order.
+		bst.insert(makeSortedKey(i)); // Insert the key.
+	}
+	bst.insert(makeSortedKey(0)); // Insert a key that is already in the tree.
+	TreeStatistics statistics = bst.statistics(); // Take a snapshot.
+	assert(statistics.inserts == 1001 && statistics.insertedKeys == 1000); // Check that the duplicate was counted as a call but not as a new key.
+	assert(statistics.rotations > 0 && statistics.searches() == 0); // Check that sorted input needed rotations and that inserts are not searches.
+	for (int i = 0; i < 800; ++i) { // Look up 500 present and 300 missing keys.
+		bst.exists(makeSortedKey(i < 500 ? i : 1000 + i)); // Look up the key.
+	}
+	assert(bst.remove(makeSortedKey(7)) == true && bst.remove("missing") == false); // Remove a present and a missing key.
+	statistics = bst.statistics(); // Take another snapshot.
+	assert(statistics.lookups == 800 && statistics.lookupHits == 500 && statistics.lookupMisses() == 300); // Check the lookup counters.
+	assert(statistics.removes == 2 && statistics.removedKeys == 1); // Check the remove counters.
+	assert(statistics.searches() == 802); // Check that every lookup and remove recorded its search.
+	assert(statistics.comparisonPercentile(1.0) <= static_cast<size_t>(bst.height())); // Check that no search compared more keys than the tree is tall.
+	assert(statistics.averageComparisons() > 1 && statistics.averageComparisons() <= bst.height()); // Check that the mean is plausible.
+	assert(statistics.size == 999 && statistics.nodeBytes == 999 * sizeof(Node) && statistics.nodeBytesReserved >= statistics.nodeBytes); // Check the node memory.
+	assert(statistics.keyBytes == bst.keyBytes() && statistics.keyBytesReleased == 8 && statistics.keyBytesReserved >= statistics.keyBytes); // Check the key memory, including the eight characters of the removed key.
+
+	TreeShape shape = bst.shape(); // Walk the AVL tree.
+	assert(shape.size == 999 && shape.height == bst.height() && shape.minimumHeight == 10); // Check the size and the heights.
+	assert(shape.maxImbalance <= 1 && shape.averageDepth > 1 && shape.averageDepth < shape.height); // Check that the AVL tree is balanced.
+	ostringstream text; // Create a stream to write the statistics to.
+	text << statistics << "\n" << shape; // Write both as text.
+	assert(text.str().find("misses=300") != string::npos && text.str().find("max_imbalance=") != string::npos); // Check that the text names the values.
+
+	bst.resetStatistics(); // Clear the counters.
+	statistics = bst.statistics(); // Take a snapshot of the cleared counters.
+	assert(statistics.inserts == 0 && statistics.lookups == 0 && statistics.searches() == 0 && statistics.size == 999); // Check that the counters were cleared but the size was not.
+	vector<string> words = { "c", "a", "b" }; // Create some words to bulk load.
+	bst.bulkLoad(words.begin(), words.end()); // Replace the contents of the tree.
+	assert(bst.statistics().rebuilds == 1 && bst.statistics().inserts == 3 && bst.statistics().insertedKeys == 3); // Check that the bulk load was counted as a rebuild and its words as inserts.
+	vector<string> batch = { "d", "a", "e", "d", "f" }; // Create a batch with a duplicate and a word that is already in the tree.
+	bst.insertMany(batch.begin(), batch.end()); // Merge the batch into the tree.
+	assert(bst.statistics().inserts == 8 && bst.statistics().insertedKeys == 6 && bst.size() == 6); // Check that every word was counted and only the new ones were added.
+	vector<string> large; // Create a batch large enough to be merged by a rebuild.
+	for (int i = 0; i < 100; ++i) { // Loop through a hundred keys.
+		large.push_back(makeSortedKey(i)); // Add the key.
+	}
+	large.push_back("a"); // Add a word that is already in the tree.
+	bst.insertMany(large.begin(), large.end()); // Merge the batch into the tree.
+	assert(bst.statistics().rebuilds == 2 && bst.statistics().inserts == 109 && bst.statistics().insertedKeys == 106); // Check that the merge counted every word and the hundred new ones.
+
+	BinarySearchTree chain(BalanceMode::None); // Create an unbalanced tree.
+	for (int i = 0; i < 100; ++i) { // Insert a hundred keys in sorted order, which makes one long path.
+		chain.insert(makeSortedKey(i)); // Insert the key.
+	}
+	shape = chain.shape(); // Walk the path.
+	assert(shape.height == 100 && shape.leaves == 1 && shape.maxImbalance == 99 && shape.averageDepth == 50.5); // Check the shape of the path.
+	assert(BinarySearchTree().shape().height == 0); // Check the shape of an empty tree.
+
+	TypedBinarySearchTree<int> ids(BalanceMode::RedBlack); // Create a typed tree, which keeps the same statistics.
+	for (int i = 0; i < 100; ++i) { // Loop through a hundred keys.
+		ids.insert(i); // Insert the key.
+	}
+	assert(ids.exists(50) == true && ids.exists(500) == false && ids.remove(7) == true); // Look up and remove some keys.
+	statistics = ids.statistics(); // Take a snapshot of the typed tree.
+	assert(statistics.inserts == 100 && statistics.lookups == 2 && statistics.lookupHits == 1 && statistics.removedKeys == 1 && statistics.searches() == 3); // Check the counters.
+	assert(statistics.nodeBytes == 99 * sizeof(TypedNode<int, void>) && statistics.keyBytes == 0 && ids.shape().height == ids.height()); // Check the memory and the shape.
+	cout << "Statistics test passed.\n"; // Print a message indicating that the test passed.
+}
+#endif
+
+void testLookupsDoNotAllocate() { // This function tests that lookups and removals of missing words never allocate memory.
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new binary search tree.
+	for (int i = 0; i < 1000; ++i) { // Loop through a thousand keys.
+		bst.insert("a word that is too long for the small string buffer " + makeSortedKey(i)); // Insert a long key into the tree.
+	}
+	string longWord = "a word that is too long for the small string buffer " + makeSortedKey(500); // Create a long word that is in the tree.
+	string_view view = longWord; // Create a view of the word.
+	size_t allocationsBefore = allocationCount.load(); // Store the number of allocations before the lookups.
+	assert(bst.exists(longWord) == true); // Look up the word as a string.
+	assert(bst.exists(view) == true); // Look up the word as a string view.
+	assert(bst.exists(longWord.c_str()) == true); // Look up the word as a C string.
+	assert(bst.exists("a word that is too long for the small string buffer, but missing") == false); // Look up a missing word given as a literal.
+	assert(bst.remove("a word that is too long for the small string buffer, but missing") == false); // Remove a missing word given as a literal.
+	assert(allocationCount.load() == allocationsBefore); // Check that none of the calls allocated memory.
+	bst.emplace(longWord.c_str(), 10); // Insert the first ten characters of the word from a pointer and a length.
+	bst.emplace(static_cast<size_t>(3), 'z'); // Insert a word built from a count and a character.
+	assert(bst.exists(view.substr(0, 10)) == true); // Check that the shortened word was inserted.
+	assert(bst.exists("zzz") == true); // Check that the built word was inserted.
+	cout << "Lookups do not allocate test passed.\n"; // Print a message indicating that the test passed.
+}
+
+int main(int argc, char* argv[]) { // This is the main function where the program starts. The first argument can name the file to load.
 	BinarySearchTree bst; // Create a new binary search tree.
-	readFromFile(bst, "C:/Users/rashe/Downloads/sample_data.txt"); // Read data from a file and insert it into the binary search tree.
+	readFromFile(bst, argc > 1 ? argv[1] : "sample_data.txt"); // Read data from the given file, or from sample_data.txt in the current path, and insert it into the binary search tree.
 	cout << "Current path is " << filesystem::current_path() << endl; // Print the current path of the program.
 	cout << "Inorder traversal of BST: " << bst.inorder() << endl; // Print the inorder traversal of the binary search tree.
 
@@ -129,21 +863,26 @@ int main() { // This is the main function where the program starts.
 	testRemoveNodeWithOneChild(); // Test removing a node with one child from the binary search tree.
 	testRemoveNodeWithTwoChildren(); // Test removing a node with two children from the binary search tree.
 	testVerifyBSTStructure(); // Test the structure of the binary search tree.
-
-    // Measure performance
-	vector<int> nodeCounts = { 100, 1000, 10000, 100000 }; // Define the number of nodes to add for performance measurement.
-	vector<double> times; // Create a vector to store the times taken to add nodes.
-
-	for (int count : nodeCounts) { // Loop through the number of nodes to add.
-		double time = measureAddPerformance(count); // Measure the time taken to add the specified number of nodes.
-		times.push_back(time); // Store the time taken in the vector.
-		cout << "Time to add " << count << " nodes: " << time << " seconds" << endl; // Print the time taken to add the nodes.
-
-		if (times.size() > 1) { // Check if there are at least two time measurements.
-			double ratio = times.back() / times[times.size() - 2]; // Calculate the ratio of the current time to the previous time.
-			cout << "Ratio to previous: " << fixed << setprecision(2) << ratio << "x" << endl; // Print the ratio to the previous time.
-        }
-    }
+	testBalancedTreeHeight(); // Test the height of the balanced binary search trees.
+	testRemoveRootOnlyNode(); // Test removing the only node of the binary search tree.
+	testAllocatorsGiveSameTree(); // Test that every node allocator gives the same tree.
+	testKeysSharingPrefix(); // Test keys that share their first eight characters.
+	testKeyPoolCompaction(); // Test rebuilding the key pool after many removals.
+	testLookupsDoNotAllocate(); // Test that lookups do not allocate memory.
+	testFrozenTreeMatchesExists(); // Test that the frozen snapshot gives the same answers as the tree.
+	testBulkLoad(); // Test building a balanced tree from a range of words.
+	testInsertMany(); // Test merging batches of words into a tree.
+	testBulkLoadFile(); // Test loading a tree from a file.
+	testIterators(); // Test walking the tree with iterators and finding bounds.
+	testRangeAndTraversals(); // Test range queries, visitor traversals and streaming.
+	testStreamRoundTrip(); // Test writing a tree to a stream and reading it back.
+	testSnapshotFile(); // Test saving a snapshot to a file and mapping it back.
+	testConcurrentTreeStress(); // Test the concurrent tree with writers and readers running at the same time.
+	testParallelOperations(); // Test the operations that run on a task pool.
+	testTypedTrees(); // Test the typed tree as a set of integers and as a map.
+#ifdef BST_ENABLE_STATS
+	testStatistics(); // Test the statistics the tree keeps when they are enabled.
+#endif
 
 	return 0; // Return 0 to indicate successful completion of the program.
 }
\ No newline at end of file
@@ -0,0 +1,306 @@
+/*
+This program benchmarks the Binary Search Tree (BST) with reproducible workloads. For every key distribution, balancing mode and size it inserts the
+keys, looks up present and missing keys, walks the tree, runs the YCSB core workloads A to E and removes the keys again, timing every operation on
+its own. It prints a table of mean and percentile times together with the height, memory and allocations of the tree, can write the same results
+as JSON or CSV, and can compare them with the CSV of an earlier run, returning a non-zero exit code if anything got slower. The comparisons that
+used to run at the end of the test program can be added with --comparisons.
+*/
+
+#include <iostream> // This is a header file library that lets us work with input and output objects, such as cout.
+#include <algorithm> // This is a header file library that lets us use algorithms such as shuffle.
+#include <fstream> // This is a header file library that lets us work with files.
+#include <iomanip> // This is a header file library that lets us work with parametric manipulators.
+#include <numeric> // This is a header file library that lets us fill a vector with increasing numbers with iota.
+#include <sstream> // This is a header file library that lets us split option values at commas.
+#include "BinarySearchTree.h" // This is a header file that contains the implementation of a binary search tree.
+#include "BenchmarkReport.h" // This is a header file that contains the measurements and the report formats.
+#include "KeyDistribution.h" // This is a header file that contains the key distributions.
+#include "Comparisons.h" // This is a header file that contains the comparisons between design choices.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+struct Options { // This struct stores the command line options.
+	vector<size_t> sizes = { 1000, 100000, 1000000 }; // This vector stores the numbers of keys to build trees with.
+	vector<Distribution> distributions; // This vector stores the key distributions to run. It is filled after parsing if no distribution was given.
+	vector<BalanceMode> modes = { BalanceMode::None, BalanceMode::AVL, BalanceMode::RedBlack }; // This vector stores the balancing modes to run.
+	size_t operations = 200000; // This number stores how many operations each lookup and mixed workload times.
+	uint64_t seed = 42; // This number stores the seed of every random choice, so runs with the same options do the same work.
+	string wordsFile; // This string stores the path of the word list for the words distribution.
+	string jsonFile; // This string stores the path to write the JSON report to, if any.
+	string csvFile; // This string stores the path to write the CSV report to, if any.
+	string baselineFile; // This string stores the path of an earlier CSV report to compare with, if any.
+	double threshold = 10; // This number stores how many percent slower a time may get before it counts as a regression.
+	bool comparisons = false; // This flag is set if the comparisons between design choices should run too.
+};
+
+static string modeName(BalanceMode mode) { // This function returns the name of the balancing mode, as used on the command line and in reports.
+	return mode == BalanceMode::None ? "none" : mode == BalanceMode::AVL ? "avl" : "redblack"; // Return the name.
+}
+
+static vector<string> splitList(const string& text) { // This function splits a comma-separated option value.
+	vector<string> items; // Create a vector to store the items.
+	istringstream stream(text); // Create a stream over the value.
+	string item; // Create a string to store each item.
+	while (getline(stream, item, ',')) { // Read the items.
+		items.push_back(item); // Store the item.
+	}
+	return items; // Return the items.
+}
+
+static void printUsage() { // This function prints the command line options.
+	cout << "Usage: Benchmark [options]\n" // Print the name of the program.
+		<< "  --sizes N,N,...          numbers of keys (default 1000,100000,1000000)\n" // Describe the sizes.
+		<< "  --distributions D,...    uniform, sorted, zipf, words (default all, words only with --words)\n" // Describe the distributions.
+		<< "  --modes M,...            none, avl, redblack (default all)\n" // Describe the modes.
+		<< "  --operations N           operations per lookup and mixed workload (default 200000)\n" // Describe the number of operations.
+		<< "  --seed N                 seed of every random choice (default 42)\n" // Describe the seed.
+		<< "  --words FILE             word list for the words distribution, one word per line\n" // Describe the word list.
+		<< "  --json FILE              write the results as JSON\n" // Describe the JSON report.
+		<< "  --csv FILE               write the results as CSV\n" // Describe the CSV report.
+		<< "  --baseline FILE          compare with the CSV of an earlier run and exit with 1 on regressions\n" // Describe the regression check.
+		<< "  --threshold PERCENT      slowdown that counts as a regression (default 10)\n" // Describe the threshold.
+		<< "  --comparisons            also run the allocator, loading, traversal, concurrency, parallel, snapshot and integer key comparisons\n"; // Describe the comparisons.
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) { // This function reads the command line options. It returns false if they are wrong.
+	bool distributionsGiven = false; // Create a flag to store whether the distributions were given.
+	for (int i = 1; i < argc; ++i) { // Loop through the arguments.
+		string option = argv[i]; // Get the option.
+		if (option == "--comparisons") { // This option takes no value.
+			options.comparisons = true; // Run the comparisons too.
+			continue; // Move on to the next option.
+		}
+		if (option == "--help" || i + 1 >= argc) { // Every other option needs a value.
+			return false; // Return false, so the usage is printed.
+		}
+		string value = argv[++i]; // Get the value.
+		try { // Converting numbers throws on bad values.
+			if (option == "--sizes") { // Read the sizes.
+				options.sizes.clear(); // Replace the default sizes.
+				for (const string& item : splitList(value)) { // Loop through the sizes.
+					options.sizes.push_back(stoull(item)); // Store the size.
+				}
+			}
+			else if (option == "--distributions") { // Read the distributions.
+				distributionsGiven = true; // Remember that the distributions were given.
+				for (const string& item : splitList(value)) { // Loop through the names.
+					Distribution distribution; // Create a variable to store the distribution.
+					if (!parseDistribution(item, distribution)) { // If the name is unknown, the options are wrong.
+						return false; // Return false, so the usage is printed.
+					}
+					options.distributions.push_back(distribution); // Store the distribution.
+				}
+			}
+			else if (option == "--modes") { // Read the modes.
+				options.modes.clear(); // Replace the default modes.
+				for (const string& item : splitList(value)) { // Loop through the names.
+					if (item != "none" && item != "avl" && item != "redblack") { // If the name is unknown, the options are wrong.
+						return false; // Return false, so the usage is printed.
+					}
+					options.modes.push_back(item == "none" ? BalanceMode::None : item == "avl" ? BalanceMode::AVL : BalanceMode::RedBlack); // Store the mode.
+				}
+			}
+			else if (option == "--operations") { options.operations = stoull(value); } // Read the number of operations.
+			else if (option == "--seed") { options.seed = stoull(value); } // Read the seed.
+			else if (option == "--words") { options.wordsFile = value; } // Read the path of the word list.
+			else if (option == "--json") { options.jsonFile = value; } // Read the path of the JSON report.
+			else if (option == "--csv") { options.csvFile = value; } // Read the path of the CSV report.
+			else if (option == "--baseline") { options.baselineFile = value; } // Read the path of the baseline.
+			else if (option == "--threshold") { options.threshold = stod(value); } // Read the threshold.
+			else { // Any other option is unknown.
+				return false; // Return false, so the usage is printed.
+			}
+		}
+		catch (const exception&) { // If a number could not be converted, the options are wrong.
+			return false; // Return false, so the usage is printed.
+		}
+	}
+	if (!distributionsGiven) { // If no distribution was given, run all that are possible.
+		options.distributions = { Distribution::Uniform, Distribution::Sorted, Distribution::Zipf }; // Run the generated distributions.
+		if (!options.wordsFile.empty()) { // The word list is only used if there is one.
+			options.distributions.push_back(Distribution::Words); // Run the word list too.
+		}
+	}
+	return true; // Return true to indicate that the options are valid.
+}
+
+static void runCase(Distribution distribution, BalanceMode mode, size_t size, const Options& options, const vector<string>& words, vector<BenchmarkResult>& results) { // This function runs every workload for one distribution, mode and size.
+	bool degenerate = mode == BalanceMode::None && distribution == Distribution::Sorted; // An unbalanced tree turns into one long path on sorted input.
+	if (degenerate && size > 10000) { // Every operation walks a path as long as the tree, so building a larger tree alone takes quadratic time.
+		cout << left << setw(9) << distributionName(distribution) << setw(10) << modeName(mode) << setw(10) << size << "skipped (an unbalanced tree degrades to a list)" << endl; // Print that the case was skipped.
+		return; // Skip the case.
+	}
+	size_t operations = degenerate ? min(options.operations, size_t(20000)) : options.operations; // Every operation on a long path visits half of it, so fewer operations are timed.
+	KeySet keys = makeKeySet(distribution, size, operations, options.seed, words); // Create the keys. The extra missing keys are inserted by workloads D and E.
+	size_t count = keys.present.size(); // Get the number of keys, which is smaller than the size if the word list is short.
+	KeyChooser chooser(count, distribution == Distribution::Zipf, options.seed + 1); // Create the chooser for lookups, skewed for the Zipf distribution.
+	KeyChooser latest(count, true, options.seed + 2); // Create the chooser of workload D, which prefers the keys inserted last.
+	mt19937_64 gen(options.seed + 3); // Create the generator that decides the kind of each mixed operation.
+	uniform_int_distribution<int> percent(0, 99); // Create a distribution for the kind of an operation.
+	uniform_int_distribution<int> scanLength(1, 100); // Create a distribution for the length of a scan, as in YCSB.
+	BinarySearchTree tree(mode); // Create the tree.
+	size_t nextMissing = count; // Create an index for the next missing key to insert. The first count missing keys are kept for failed lookups.
+	size_t checksum = 0; // Create a counter for the results, so the operations cannot be optimized away.
+
+	auto record = [&](const char* workload, const LatencyRecorder& recorder) { // Create a function that stores and prints the result of a workload.
+		BenchmarkResult result; // Create the result.
+		result.distribution = distributionName(distribution); // Store the name of the distribution.
+		result.mode = modeName(mode); // Store the name of the mode.
+		result.size = count; // Store the number of keys.
+		result.workload = workload; // Store the name of the workload.
+		recorder.finish(result); // Store the times and allocations.
+		result.height = tree.height(); // Store the height of the tree.
+		result.nodeBytes = tree.size() * sizeof(Node); // Store the memory of the nodes.
+		result.keyBytes = tree.keyBytes(); // Store the memory of the key pool.
+		printResult(cout, result); // Print the result.
+		results.push_back(result); // Store the result.
+	};
+	auto insertedKey = [&](size_t index) -> const string& { // Create a function that returns the key inserted at the given position, counting the inserts of workloads D and E.
+		return index < count ? keys.present[index] : keys.missing[index]; // The inserted missing keys start at index count, right after the present keys.
+	};
+
+	{
+		LatencyRecorder recorder(count); // Create a recorder for the inserts.
+		for (const string& key : keys.present) { // Loop through the keys in insertion order.
+			recorder.begin(); // Start the operation.
+			tree.insert(key); // Insert the key.
+			recorder.end(); // Finish the operation.
+		}
+		record("insert", recorder); // Store the result.
+	}
+	{
+		LatencyRecorder recorder(operations); // Create a recorder for the successful lookups.
+		for (size_t i = 0; i < operations; ++i) { // Loop through the operations.
+			const string& key = keys.present[chooser.next()]; // Pick a key before starting the clock.
+			recorder.begin(); // Start the operation.
+			checksum += tree.exists(key) ? 1 : 0; // Look the key up.
+			recorder.end(); // Finish the operation.
+		}
+		record("exists-hit", recorder); // Store the result.
+	}
+	{
+		LatencyRecorder recorder(operations); // Create a recorder for the failed lookups.
+		for (size_t i = 0; i < operations; ++i) { // Loop through the operations.
+			const string& key = keys.missing[chooser.next()]; // Pick a missing key before starting the clock.
+			recorder.begin(); // Start the operation.
+			checksum += tree.exists(key) ? 1 : 0; // Look the key up.
+			recorder.end(); // Finish the operation.
+		}
+		record("exists-miss", recorder); // Store the result.
+	}
+	{
+		LatencyRecorder recorder(5); // Create a recorder for the traversals. Timing single visits would mostly time the clock, so every pass is one sample.
+		for (int pass = 0; pass < 5; ++pass) { // Walk the tree five times.
+			auto start = steady_clock::now(); // Start the pass.
+			tree.forEach([&checksum](string_view key) { checksum += key.size(); }); // Visit every key in sorted order.
+			recorder.add(duration<double, nano>(steady_clock::now() - start).count() / max(count, size_t(1))); // Store the time per key.
+		}
+		record("traverse", recorder); // Store the result. Its times are per key.
+	}
+
+	struct Mix { const char* name; int readPercent; char kind; }; // This struct describes a YCSB core workload: the share of reads and what the other operations do.
+	for (const Mix& mix : { Mix{ "ycsb-a", 50, 'u' }, Mix{ "ycsb-b", 95, 'u' }, Mix{ "ycsb-c", 100, 'u' }, Mix{ "ycsb-d", 95, 'l' }, Mix{ "ycsb-e", 95, 's' } }) { // Loop through workloads A to E.
+		LatencyRecorder recorder(operations); // Create a recorder for the workload.
+		for (size_t i = 0; i < operations; ++i) { // Loop through the operations.
+			bool read = percent(gen) < mix.readPercent; // Decide the kind of the operation before starting the clock.
+			if (!read && mix.kind == 'u') { // Updates replace a key, which for a set means removing and inserting it again.
+				const string& key = keys.present[chooser.next()]; // Pick a key.
+				recorder.begin(); // Start the operation.
+				tree.remove(key); // Remove the key.
+				tree.insert(key); // Insert it again.
+				recorder.end(); // Finish the operation.
+			}
+			else if (!read) { // Workloads D and E insert new keys.
+				const string& key = insertedKey(nextMissing++); // Pick the next new key.
+				recorder.begin(); // Start the operation.
+				tree.insert(key); // Insert the key.
+				recorder.end(); // Finish the operation.
+			}
+			else if (mix.kind == 'l') { // Workload D reads the keys that were inserted last.
+				const string& key = insertedKey(nextMissing - 1 - latest.nextRank()); // Pick a key, most likely one of the newest.
+				recorder.begin(); // Start the operation.
+				checksum += tree.exists(key) ? 1 : 0; // Look the key up.
+				recorder.end(); // Finish the operation.
+			}
+			else if (mix.kind == 's') { // Workload E reads short ranges.
+				const string& key = keys.present[chooser.next()]; // Pick the start of the range.
+				int length = scanLength(gen); // Pick the number of keys to read.
+				recorder.begin(); // Start the operation.
+				auto it = tree.lower_bound(key); // Find the first key of the range.
+				for (int k = 0; k < length && it != tree.end(); ++k, ++it) { // Read the keys of the range.
+					checksum += (*it).size(); // Use the key.
+				}
+				recorder.end(); // Finish the operation.
+			}
+			else { // The other workloads read single keys.
+				const string& key = keys.present[chooser.next()]; // Pick a key.
+				recorder.begin(); // Start the operation.
+				checksum += tree.exists(key) ? 1 : 0; // Look the key up.
+				recorder.end(); // Finish the operation.
+			}
+		}
+		record(mix.name, recorder); // Store the result.
+	}
+	{
+		vector<size_t> order(count); // Create a vector to store the order in which the keys are removed.
+		iota(order.begin(), order.end(), size_t(0)); // Start with the insertion order.
+		shuffle(order.begin(), order.end(), gen); // Remove the keys in random order.
+		LatencyRecorder recorder(count); // Create a recorder for the removals.
+		for (size_t index : order) { // Loop through the keys.
+			const string& key = keys.present[index]; // Get the key.
+			recorder.begin(); // Start the operation.
+			checksum += tree.remove(key) ? 1 : 0; // Remove the key.
+			recorder.end(); // Finish the operation.
+		}
+		record("remove", recorder); // Store the result. The keys inserted by workloads D and E are still in the tree.
+	}
+	if (checksum == 0 && count > 0) { // Use the counter, so the compiler keeps every operation.
+		cout << "No operation found a key." << endl; // Print a warning, which never happens with valid keys.
+	}
+}
+
+int main(int argc, char* argv[]) { // This is the main function where the program starts.
+	Options options; // Create the options.
+	if (!parseOptions(argc, argv, options)) { // If the options are wrong, explain them.
+		printUsage(); // Print the options.
+		return 2; // Return 2 to indicate wrong options.
+	}
+	vector<string> words; // Create a vector to store the word list.
+	if (find(options.distributions.begin(), options.distributions.end(), Distribution::Words) != options.distributions.end() && !loadWordList(options.wordsFile, words)) { // The words distribution needs a word list.
+		cout << "The words distribution needs a word list, but \"" << options.wordsFile << "\" cannot be read." << endl; // Print the error.
+		return 2; // Return 2 to indicate wrong options.
+	}
+
+	vector<BenchmarkResult> results; // Create a vector to store the results.
+	cout << "seed " << options.seed << ", " << options.operations << " operations per workload, times in nanoseconds, traverse per key" << endl; // Print the options that decide the results.
+	printResultHeader(cout); // Print the column names.
+	for (size_t size : options.sizes) { // Loop through the sizes.
+		for (Distribution distribution : options.distributions) { // Loop through the distributions.
+			for (BalanceMode mode : options.modes) { // Loop through the modes.
+				runCase(distribution, mode, size, options, words, results); // Run the workloads.
+			}
+		}
+	}
+
+	if (!options.jsonFile.empty()) { // If a JSON report was asked for, write it.
+		ofstream file(options.jsonFile); // Open the file.
+		writeJson(file, results, options.seed, options.operations); // Write the results.
+	}
+	if (!options.csvFile.empty()) { // If a CSV report was asked for, write it.
+		ofstream file(options.csvFile); // Open the file.
+		writeCsv(file, results); // Write the results.
+	}
+	size_t regressions = 0; // Create a counter for the regressions.
+	if (!options.baselineFile.empty()) { // If a baseline was given, compare with it.
+		vector<BenchmarkResult> baseline; // Create a vector to store the baseline.
+		if (!readCsv(options.baselineFile, baseline)) { // If the baseline cannot be read, nothing can be compared.
+			cout << "The baseline \"" << options.baselineFile << "\" is not a CSV report of this benchmark." << endl; // Print the error.
+			return 2; // Return 2 to indicate wrong options.
+		}
+		regressions = reportRegressions(baseline, results, options.threshold, cout); // Compare the results and print the regressions.
+	}
+	if (options.comparisons) { // If the comparisons were asked for, run them.
+		runComparisons(); // Run the comparisons.
+	}
+	return regressions > 0 ? 1 : 0; // Return 1 if anything got slower, so scripts can fail on regressions.
+}
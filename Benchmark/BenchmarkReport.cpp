@@ -0,0 +1,166 @@
+/*
+This implementation file provides the implementations for recording and reporting declared in the header file. Percentiles use the nearest-rank
+method on the sorted times, and the CSV format is both the output for spreadsheets and the input of the regression check.
+*/
+
+#include "BenchmarkReport.h" // This is a header file that contains the declaration of the benchmark results.
+#include <algorithm> // This is a header file library that lets us use algorithms such as sort.
+#include <cmath> // This is a header file library that lets us use math functions such as ceil.
+#include <fstream> // This is a header file library that lets us work with files.
+#include <iomanip> // This is a header file library that lets us work with parametric manipulators.
+#include <map> // This is a header file library that lets us look results up by name.
+#include <sstream> // This is a header file library that lets us split lines into fields.
+
+static const char* csvColumns = "distribution,mode,size,workload,operations,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,height,node_bytes,key_bytes,allocations_per_op"; // This string stores the header line of the CSV format.
+
+string BenchmarkResult::caseName() const { // This function returns the name that identifies the case and workload across runs.
+	return distribution + "/" + mode + "/" + to_string(size) + "/" + workload; // Join the parts that identify the result.
+}
+
+LatencyRecorder::LatencyRecorder(size_t expected) { // This is a constructor that makes room for the expected number of operations, so recording never allocates.
+	samples.reserve(expected); // Make room for the times.
+	allocationsBefore = allocationCount.load(); // Start counting allocations after the room was made.
+}
+
+void LatencyRecorder::add(double nanoseconds) { // This function stores a time that was measured some other way.
+	samples.push_back(nanoseconds); // Store the time.
+}
+
+void LatencyRecorder::finish(BenchmarkResult& result) const { // This function stores the number of operations, the mean, the percentiles and the allocations per operation in the result.
+	size_t allocations = allocationCount.load() - allocationsBefore; // Count the allocations of the workload before sorting allocates.
+	result.operations = samples.size(); // Store the number of operations.
+	if (samples.empty()) { // A workload without operations has no times.
+		return; // Return without times.
+	}
+	vector<double> sorted = samples; // Create a copy of the times to sort.
+	sort(sorted.begin(), sorted.end()); // Sort the times.
+	auto percentile = [&sorted](double fraction) { // Create a function that returns the time the given fraction of the operations stayed under.
+		size_t rank = static_cast<size_t>(ceil(fraction * sorted.size())); // Find the rank of the percentile, counting from 1.
+		return sorted[max(rank, size_t(1)) - 1]; // Return the time at that rank.
+	};
+	double total = 0; // Create a variable to store the sum of the times.
+	for (double sample : sorted) { // Loop through the times.
+		total += sample; // Add the time.
+	}
+	result.meanNs = total / sorted.size(); // Store the mean.
+	result.p50Ns = percentile(0.50); // Store the median.
+	result.p90Ns = percentile(0.90); // Store the 90th percentile.
+	result.p99Ns = percentile(0.99); // Store the 99th percentile.
+	result.p999Ns = percentile(0.999); // Store the 99.9th percentile.
+	result.maxNs = sorted.back(); // Store the slowest time.
+	result.allocationsPerOperation = double(allocations) / sorted.size(); // Store the allocations per operation.
+}
+
+void printResultHeader(ostream& out) { // This function prints the column names of the console table.
+	out << left << setw(9) << "keys" << setw(10) << "mode" << setw(10) << "size" << setw(14) << "workload" << right << setw(10) << "mean ns" << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "p99.9" << setw(11) << "max" << setw(8) << "height" << setw(12) << "node MB" << setw(10) << "key MB" << setw(11) << "allocs/op" << endl; // Print the column names.
+}
+
+void printResult(ostream& out, const BenchmarkResult& result) { // This function prints one result as a row of the console table.
+	out << left << setw(9) << result.distribution << setw(10) << result.mode << setw(10) << result.size << setw(14) << result.workload << right << fixed << setprecision(1); // Print the names of the case.
+	out << setw(10) << result.meanNs << setw(10) << result.p50Ns << setw(10) << result.p90Ns << setw(10) << result.p99Ns << setw(10) << result.p999Ns << setw(11) << result.maxNs; // Print the times.
+	out << setw(8) << result.height << setprecision(2) << setw(12) << result.nodeBytes / 1048576.0 << setw(10) << result.keyBytes / 1048576.0 << setprecision(3) << setw(11) << result.allocationsPerOperation << endl; // Print the shape and the memory of the tree.
+}
+
+void writeJson(ostream& out, const vector<BenchmarkResult>& results, uint64_t seed, size_t operations) { // This function writes the results as a JSON document, together with the options that produced them.
+	out << "{\n  \"seed\": " << seed << ",\n  \"operations\": " << operations << ",\n  \"results\": ["; // Write the options and open the list of results.
+	out << setprecision(10); // Write the times with enough digits to compare them.
+	for (size_t i = 0; i < results.size(); ++i) { // Loop through the results.
+		const BenchmarkResult& result = results[i]; // Get the result.
+		out << (i == 0 ? "\n" : ",\n") << "    {\"distribution\": \"" << result.distribution << "\", \"mode\": \"" << result.mode << "\", \"size\": " << result.size << ", \"workload\": \"" << result.workload << "\""; // Write the names of the case. None of them need escaping.
+		out << ", \"operations\": " << result.operations << ", \"mean_ns\": " << result.meanNs << ", \"p50_ns\": " << result.p50Ns << ", \"p90_ns\": " << result.p90Ns << ", \"p99_ns\": " << result.p99Ns << ", \"p999_ns\": " << result.p999Ns << ", \"max_ns\": " << result.maxNs; // Write the times.
+		out << ", \"height\": " << result.height << ", \"node_bytes\": " << result.nodeBytes << ", \"key_bytes\": " << result.keyBytes << ", \"allocations_per_op\": " << result.allocationsPerOperation << "}"; // Write the shape and the memory of the tree.
+	}
+	out << "\n  ]\n}\n"; // Close the list and the document.
+}
+
+void writeCsv(ostream& out, const vector<BenchmarkResult>& results) { // This function writes the results as CSV, one row per workload.
+	out << csvColumns << "\n" << setprecision(10); // Write the header line, and write the times with enough digits to compare them.
+	for (const BenchmarkResult& result : results) { // Loop through the results.
+		out << result.distribution << "," << result.mode << "," << result.size << "," << result.workload << "," << result.operations << ","; // Write the names of the case.
+		out << result.meanNs << "," << result.p50Ns << "," << result.p90Ns << "," << result.p99Ns << "," << result.p999Ns << "," << result.maxNs << ","; // Write the times.
+		out << result.height << "," << result.nodeBytes << "," << result.keyBytes << "," << result.allocationsPerOperation << "\n"; // Write the shape and the memory of the tree.
+	}
+}
+
+bool readCsv(const string& filename, vector<BenchmarkResult>& results) { // This function reads results written by writeCsv. It returns false if the file cannot be opened or has the wrong columns.
+	ifstream file(filename); // Open the file.
+	string line; // Create a string to store each line.
+	if (!file || !getline(file, line) || line != csvColumns) { // If the file cannot be read or was not written by writeCsv, it cannot be compared.
+		return false; // Return false to indicate the failure.
+	}
+	while (getline(file, line)) { // Read the rows.
+		istringstream row(line); // Create a stream over the row.
+		BenchmarkResult result; // Create a result to fill.
+		string size, operations, height, nodeBytes, keyBytes, mean, p50, p90, p99, p999, maximum, allocations; // Create strings to store the numeric fields.
+		getline(row, result.distribution, ','); // Read the distribution.
+		getline(row, result.mode, ','); // Read the mode.
+		getline(row, size, ','); // Read the size.
+		getline(row, result.workload, ','); // Read the workload.
+		getline(row, operations, ','); // Read the number of operations.
+		getline(row, mean, ','); // Read the mean.
+		getline(row, p50, ','); // Read the median.
+		getline(row, p90, ','); // Read the 90th percentile.
+		getline(row, p99, ','); // Read the 99th percentile.
+		getline(row, p999, ','); // Read the 99.9th percentile.
+		getline(row, maximum, ','); // Read the slowest time.
+		getline(row, height, ','); // Read the height.
+		getline(row, nodeBytes, ','); // Read the node memory.
+		getline(row, keyBytes, ','); // Read the key memory.
+		if (!getline(row, allocations)) { // If the row is too short, the file is damaged.
+			return false; // Return false to indicate the failure.
+		}
+		result.size = stoull(size); // Convert the size.
+		result.operations = stoull(operations); // Convert the number of operations.
+		result.meanNs = stod(mean); // Convert the mean.
+		result.p50Ns = stod(p50); // Convert the median.
+		result.p90Ns = stod(p90); // Convert the 90th percentile.
+		result.p99Ns = stod(p99); // Convert the 99th percentile.
+		result.p999Ns = stod(p999); // Convert the 99.9th percentile.
+		result.maxNs = stod(maximum); // Convert the slowest time.
+		result.height = stoi(height); // Convert the height.
+		result.nodeBytes = stoull(nodeBytes); // Convert the node memory.
+		result.keyBytes = stoull(keyBytes); // Convert the key memory.
+		result.allocationsPerOperation = stod(allocations); // Convert the allocations per operation.
+		results.push_back(result); // Store the result.
+	}
+	return true; // Return true to indicate success.
+}
+
+size_t reportRegressions(const vector<BenchmarkResult>& baseline, const vector<BenchmarkResult>& results, double thresholdPercent, ostream& out) { // This function compares the results with a baseline, prints every regression and returns how many there are.
+	map<string, const BenchmarkResult*> previous; // Create a map from the name of every baseline result to the result.
+	for (const BenchmarkResult& result : baseline) { // Loop through the baseline.
+		previous[result.caseName()] = &result; // Store the result under its name.
+	}
+	double factor = 1.0 + thresholdPercent / 100.0; // Calculate how much slower a time may get before it counts as a regression.
+	size_t regressions = 0; // Create a counter for the regressions.
+	size_t compared = 0; // Create a counter for the results found in the baseline.
+	out << fixed << setprecision(1); // Print the times with one decimal.
+	for (const BenchmarkResult& result : results) { // Loop through the new results.
+		auto found = previous.find(result.caseName()); // Find the same case in the baseline.
+		if (found == previous.end()) { // Cases the baseline did not run cannot regress.
+			continue; // Skip the case.
+		}
+		const BenchmarkResult& old = *found->second; // Get the baseline result.
+		++compared; // Count the comparison.
+		// The median and the mean are compared, because single tail times are too noisy to fail a run on. Height and allocations are exact,
+		// so any increase is reported.
+		if (result.p50Ns > old.p50Ns * factor) { // If the median got slower, report it.
+			out << "REGRESSION " << result.caseName() << ": p50 " << old.p50Ns << " -> " << result.p50Ns << " ns" << endl; // Print the regression.
+			++regressions; // Count the regression.
+		}
+		if (result.meanNs > old.meanNs * factor) { // If the mean got slower, report it.
+			out << "REGRESSION " << result.caseName() << ": mean " << old.meanNs << " -> " << result.meanNs << " ns" << endl; // Print the regression.
+			++regressions; // Count the regression.
+		}
+		if (result.height > old.height) { // If the tree got taller, report it.
+			out << "REGRESSION " << result.caseName() << ": height " << old.height << " -> " << result.height << endl; // Print the regression.
+			++regressions; // Count the regression.
+		}
+		if (result.allocationsPerOperation > old.allocationsPerOperation + 0.001) { // If the workload allocates more, report it.
+			out << "REGRESSION " << result.caseName() << ": allocations per operation " << setprecision(3) << old.allocationsPerOperation << " -> " << result.allocationsPerOperation << setprecision(1) << endl; // Print the regression.
+			++regressions; // Count the regression.
+		}
+	}
+	out << compared << " results compared with the baseline, " << regressions << " regressions above " << thresholdPercent << "%" << endl; // Print the summary.
+	return regressions; // Return the number of regressions.
+}
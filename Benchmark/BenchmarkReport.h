@@ -0,0 +1,64 @@
+/*
+This header file defines how the benchmark records and reports its measurements. Every operation is timed on its own, so the report can give
+percentiles as well as the mean, and the results can be written as JSON or CSV and compared with the CSV of an earlier run to catch regressions.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <chrono> // This is a header file library that lets us work with time.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <iostream> // This is a header file library that lets us work with input and output objects, such as ostream.
+#include <string> // This is a header file library that lets us work with strings.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+#include "AllocationCounter.h" // This is a header file that contains the counter of the allocations the program makes.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+using namespace chrono; // using chrono namespace to avoid writing chrono:: before time measurement functions
+
+struct BenchmarkResult { // This struct stores the measurements of one workload in one benchmark case.
+	string distribution; // This string stores the name of the key distribution.
+	string mode; // This string stores the name of the balancing mode.
+	size_t size = 0; // This number stores how many keys the tree held when the case started.
+	string workload; // This string stores the name of the workload.
+	size_t operations = 0; // This number stores how many operations were timed.
+	double meanNs = 0; // This number stores the mean time of an operation in nanoseconds.
+	double p50Ns = 0; // This number stores the median time of an operation in nanoseconds.
+	double p90Ns = 0; // This number stores the time 90% of the operations stayed under.
+	double p99Ns = 0; // This number stores the time 99% of the operations stayed under.
+	double p999Ns = 0; // This number stores the time 99.9% of the operations stayed under.
+	double maxNs = 0; // This number stores the time of the slowest operation.
+	int height = 0; // This number stores the height of the tree after the workload.
+	size_t nodeBytes = 0; // This number stores the memory of the nodes of the tree after the workload.
+	size_t keyBytes = 0; // This number stores the memory of the key pool of the tree after the workload.
+	double allocationsPerOperation = 0; // This number stores how many times the workload allocated memory per operation.
+
+	string caseName() const; // This function returns the name that identifies the case and workload across runs.
+};
+
+class LatencyRecorder { // This class collects the time of every operation of a workload.
+private: // This section contains private members of the class.
+	vector<double> samples; // This vector stores the time of every operation in nanoseconds.
+	steady_clock::time_point started; // This time point stores when the current operation started.
+	size_t allocationsBefore = 0; // This number stores the allocation count when the workload started.
+
+public: // This section contains public members of the class.
+	explicit LatencyRecorder(size_t expected); // This is a constructor that makes room for the expected number of operations, so recording never allocates.
+
+	void begin() { // This function marks the start of an operation.
+		started = steady_clock::now(); // Read the clock.
+	}
+
+	void end() { // This function marks the end of an operation and stores its time.
+		samples.push_back(duration<double, nano>(steady_clock::now() - started).count()); // Store the time since the start.
+	}
+
+	void add(double nanoseconds); // This function stores a time that was measured some other way.
+	void finish(BenchmarkResult& result) const; // This function stores the number of operations, the mean, the percentiles and the allocations per operation in the result.
+};
+
+void printResultHeader(ostream& out); // This function prints the column names of the console table.
+void printResult(ostream& out, const BenchmarkResult& result); // This function prints one result as a row of the console table.
+void writeJson(ostream& out, const vector<BenchmarkResult>& results, uint64_t seed, size_t operations); // This function writes the results as a JSON document, together with the options that produced them.
+void writeCsv(ostream& out, const vector<BenchmarkResult>& results); // This function writes the results as CSV, one row per workload.
+bool readCsv(const string& filename, vector<BenchmarkResult>& results); // This function reads results written by writeCsv. It returns false if the file cannot be opened or has the wrong columns.
+size_t reportRegressions(const vector<BenchmarkResult>& baseline, const vector<BenchmarkResult>& results, double thresholdPercent, ostream& out); // This function compares the results with a baseline, prints every regression and returns how many there are.
@@ -0,0 +1,358 @@
+/*
+This implementation file provides the comparison benchmarks declared in the header file. They use fixed seeds, so every run compares the same keys,
+and they print their results as they go, because each comparison needs its own columns.
+*/
+
+#include "Comparisons.h" // This is a header file that contains the declaration of the comparisons.
+#include "BenchmarkReport.h" // This is a header file that contains the allocation counter.
+#include "KeyDistribution.h" // This is a header file that contains the key generators.
+#include <cassert> // This is a header file library that lets us use the assert function to check the results.
+#include <algorithm> // This is a header file library that lets us use algorithms such as shuffle.
+#include <filesystem> // This is a header file library that lets us work with file systems.
+#include <fstream> // This is a header file library that lets us work with files.
+#include <iomanip> // This is a header file library that lets us work with parametric manipulators.
+#include <mutex> // This is a header file library that lets us protect shared data with a lock.
+#include <thread> // This is a header file library that lets us run code on several threads.
+#include "BinarySearchTree.h" // This is a header file that contains the implementation of a binary search tree.
+#include "ConcurrentBinarySearchTree.h" // This is a header file that contains the binary search tree that many threads can use at the same time.
+
+template <template <typename> class Allocator>
+double measureAllocatorPerformance(const vector<string>& keys) { // This function measures the time taken to build and destroy a tree that uses the given allocator.
+	auto start = high_resolution_clock::now(); // Start measuring time.
+	{
+		BasicBinarySearchTree<Allocator> bst(BalanceMode::AVL); // Create a new binary search tree that uses the given allocator.
+		for (const string& key : keys) { // Loop through the keys.
+			bst.insert(key); // Insert the key into the tree.
+		}
+	} // The tree is destroyed here, so the teardown is part of the measured time.
+	auto end = high_resolution_clock::now(); // Stop measuring time.
+	duration<double> diff = end - start; // Calculate the time taken to build and destroy the tree.
+	return diff.count(); // Return the time taken in seconds.
+}
+
+template <typename Tree>
+double measureLookupPerformance(const Tree& bst, const vector<string>& probes, double& allocationsPerLookup) { // This function measures the average time of a lookup in nanoseconds.
+	size_t found = 0; // Create a counter for the number of keys found, so the lookups cannot be optimized away.
+	size_t allocationsBefore = allocationCount.load(); // Store the number of allocations before the lookups.
+	auto start = high_resolution_clock::now(); // Start measuring time.
+	for (const string& probe : probes) { // Loop through the keys to look up.
+		found += bst.exists(probe) ? 1 : 0; // Look up the key.
+	}
+	auto end = high_resolution_clock::now(); // Stop measuring time.
+	duration<double, nano> diff = end - start; // Calculate the time taken for all lookups.
+	allocationsPerLookup = double(allocationCount.load() - allocationsBefore) / probes.size(); // Calculate the number of allocations per lookup.
+	assert(found <= probes.size()); // Use the counter.
+	return diff.count() / probes.size(); // Return the time per lookup.
+}
+
+class LockedBinarySearchTree { // This class protects a binary search tree with one mutex, which is how the tree was shared between threads before.
+private: // This section contains private members of the class.
+	mutable mutex lock; // This mutex protects the tree.
+	BinarySearchTree tree; // This is the tree that is shared.
+
+public: // This section contains public members of the class.
+	LockedBinarySearchTree() : tree(BalanceMode::AVL) {} // This is the default constructor for an empty balanced tree.
+	bool insert(string_view word) { lock_guard<mutex> guard(lock); bool added = !tree.exists(word); tree.insert(word); return added; } // This function inserts the word while holding the lock.
+	bool remove(string_view word) { lock_guard<mutex> guard(lock); return tree.remove(word); } // This function removes the word while holding the lock.
+	bool exists(string_view word) const { lock_guard<mutex> guard(lock); return tree.exists(word); } // This function checks the word while holding the lock.
+};
+
+template <typename Tree>
+double measureConcurrentThroughput(int threadCount, int readPercent, const vector<string>& keys) { // This function measures how many million operations per second the given number of threads get through.
+	Tree tree; // Create a new tree.
+	for (size_t i = 0; i < keys.size(); i += 2) { // Loop through every second key.
+		tree.insert(keys[i]); // Fill half of the key space, so lookups and updates both hit and miss.
+	}
+	const int totalOperations = 400000; // Define the number of operations all threads perform together.
+	vector<thread> threads; // Create a vector to store the threads.
+	auto start = high_resolution_clock::now(); // Start measuring time.
+	for (int t = 0; t < threadCount; ++t) { // Loop through the threads.
+		threads.emplace_back([&tree, &keys, t, threadCount, readPercent]() { // Start a thread.
+			mt19937 gen(t); // Create a random number generator with a fixed seed per thread.
+			uniform_int_distribution<size_t> keyDis(0, keys.size() - 1); // Create a distribution over the keys.
+			uniform_int_distribution<> percentDis(0, 99); // Create a distribution that decides the kind of each operation.
+			size_t found = 0; // Create a counter for the keys found, so the lookups cannot be optimized away.
+			for (int i = 0; i < totalOperations / threadCount; ++i) { // Loop through the operations of this thread.
+				const string& key = keys[keyDis(gen)]; // Pick a key.
+				int kind = percentDis(gen); // Pick the kind of operation.
+				if (kind < readPercent) { // Most operations are lookups.
+					found += tree.exists(key) ? 1 : 0; // Look the key up.
+				}
+				else if (kind % 2 == 0) { // Half of the updates are inserts.
+					tree.insert(key); // Insert the key.
+				}
+				else { // The other half are removals, so the size of the tree stays about the same.
+					tree.remove(key); // Remove the key.
+				}
+			}
+			assert(found <= keys.size() * 1000); // Use the counter.
+		});
+	}
+	for (thread& worker : threads) { // Loop through the threads.
+		worker.join(); // Wait for the thread to finish.
+	}
+	duration<double> diff = high_resolution_clock::now() - start; // Calculate the time taken by all threads.
+	return totalOperations / diff.count() / 1e6; // Return the throughput in million operations per second.
+}
+
+static void compareAllocators() { // This function compares the node allocators.
+	for (int count : { 100000, 1000000 }) { // Loop through the number of nodes to add.
+		mt19937 gen(42); // Create a random number generator with a fixed seed, so every allocator gets the same keys.
+		uniform_int_distribution<> dis(1, 10000000); // Create a uniform distribution for random numbers.
+		vector<string> keys; // Create a vector to store the keys.
+		for (int i = 0; i < count; ++i) { // Loop through the number of nodes.
+			keys.push_back(makeSortedKey(dis(gen))); // Add a random key to the vector.
+		}
+		cout << "--- build and destroy " << count << " nodes ---" << endl; // Print the case being measured.
+		cout << "new:   " << setprecision(6) << measureAllocatorPerformance<NewAllocator>(keys) << " seconds" << endl; // Print the time taken with nodes allocated by new.
+		cout << "arena: " << setprecision(6) << measureAllocatorPerformance<ArenaAllocator>(keys) << " seconds" << endl; // Print the time taken with nodes taken from an arena.
+		cout << "pool:  " << setprecision(6) << measureAllocatorPerformance<PoolAllocator>(keys) << " seconds" << endl; // Print the time taken with nodes taken from a pool.
+	}
+}
+
+static void compareLoading() { // This function compares bulk loading and batched inserts with single inserts.
+	mt19937 gen(11); // Create a random number generator with a fixed seed.
+	vector<string> words; // Create a vector to store the words.
+	for (int i = 0; i < 1000000; ++i) { // Loop through a million words.
+		words.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+	}
+	vector<string> sortedWords = words; // Create a sorted copy of the words.
+	sort(sortedWords.begin(), sortedWords.end()); // Sort the words.
+	cout << "--- load 1000000 words ---" << endl; // Print the case being measured.
+	for (const vector<string>* input : { &words, &sortedWords }) { // Loop through shuffled and sorted input.
+		const char* label = input == &words ? "shuffled" : "sorted"; // Store the name of the input.
+		auto start = high_resolution_clock::now(); // Start measuring time.
+		BinarySearchTree single(BalanceMode::AVL); // Create a tree that is filled one word at a time.
+		for (const string& word : *input) { // Loop through the words.
+			single.insert(word); // Insert the word.
+		}
+		duration<double> singleTime = high_resolution_clock::now() - start; // Calculate the time taken by single inserts.
+		start = high_resolution_clock::now(); // Start measuring time again.
+		BinarySearchTree bulk(BalanceMode::AVL); // Create a tree that is bulk loaded.
+		bulk.bulkLoad(input->begin(), input->end()); // Build the tree from all words at once.
+		duration<double> bulkTime = high_resolution_clock::now() - start; // Calculate the time taken by the bulk load.
+		cout << label << ": single inserts " << setprecision(3) << singleTime.count() << " s, bulk load " << bulkTime.count() << " s" << endl; // Print both times.
+	}
+
+	for (size_t loaded : { 900000, 500000 }) { // Loop through the number of words that are already in the tree.
+		BinarySearchTree single(BalanceMode::AVL); // Create a tree that receives a batch one word at a time.
+		BinarySearchTree batched(BalanceMode::AVL); // Create a tree that receives the same batch with insertMany.
+		single.bulkLoad(words.begin(), words.begin() + loaded); // Load the first words into the first tree.
+		batched.bulkLoad(words.begin(), words.begin() + loaded); // Load the same words into the second tree.
+		auto start = high_resolution_clock::now(); // Start measuring time.
+		for (size_t i = loaded; i < words.size(); ++i) { // Loop through the remaining words.
+			single.insert(words[i]); // Insert the word.
+		}
+		duration<double> singleTime = high_resolution_clock::now() - start; // Calculate the time taken by single inserts.
+		start = high_resolution_clock::now(); // Start measuring time again.
+		batched.insertMany(words.begin() + loaded, words.end()); // Merge the remaining words in one batch.
+		duration<double> batchTime = high_resolution_clock::now() - start; // Calculate the time taken by the batch.
+		cout << words.size() - loaded << " word batch into " << loaded << " word tree: single inserts " << singleTime.count() << " s, insertMany " << batchTime.count() << " s" << endl; // Print both times.
+	}
+}
+
+static void compareTraversals() { // This function measures the ways of visiting every key of a large tree.
+	mt19937 gen(23); // Create a random number generator with a fixed seed.
+	vector<string> words; // Create a vector to store the words.
+	for (int i = 0; i < 1000000; ++i) { // Loop through a million words.
+		words.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+	}
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new balanced binary search tree.
+	bst.bulkLoad(words.begin(), words.end()); // Build the tree from the words.
+	cout << "--- visit " << bst.size() << " keys ---" << endl; // Print the case being measured.
+	size_t allocationsBefore = allocationCount.load(); // Store the number of allocations before the traversal.
+	auto start = high_resolution_clock::now(); // Start measuring time.
+	size_t characters = bst.inorder().size(); // Build the inorder string.
+	duration<double> stringTime = high_resolution_clock::now() - start; // Calculate the time taken to build the string.
+	size_t stringAllocations = allocationCount.load() - allocationsBefore; // Calculate the number of allocations the string needed.
+	start = high_resolution_clock::now(); // Start measuring time again.
+	size_t visited = 0; // Create a counter for the characters the visitor sees.
+	bst.forEach([&visited](string_view key) { visited += key.size() + 1; }); // Visit every key.
+	duration<double> visitTime = high_resolution_clock::now() - start; // Calculate the time taken by the visitor.
+	start = high_resolution_clock::now(); // Start measuring time again.
+	size_t iterated = 0; // Create a counter for the characters the iterator sees.
+	for (string_view key : bst) { // Walk every key with the iterator.
+		iterated += key.size() + 1; // Count the characters of the key.
+	}
+	duration<double> iteratorTime = high_resolution_clock::now() - start; // Calculate the time taken by the iterator.
+	assert(characters == visited && visited == iterated); // Check that every way saw the same keys.
+	cout << "inorder string: " << setprecision(3) << stringTime.count() << " s (" << stringAllocations << " allocations), forEach: " << visitTime.count() << " s, iterator: " << iteratorTime.count() << " s" << endl; // Print the time taken by each way.
+}
+
+static void compareConcurrentThroughput() { // This function measures how the concurrent tree scales with the number of threads, compared with a tree behind one mutex.
+	vector<string> keys; // Create a vector to store the key space.
+	for (int i = 0; i < 200000; ++i) { // Loop through the keys.
+		keys.push_back(makeSortedKey(i)); // Add the key to the key space.
+	}
+	vector<int> threadCounts = { 1, 2, 4 }; // Define the numbers of threads to measure.
+	for (int count = 8; count <= static_cast<int>(thread::hardware_concurrency()); count *= 2) { // Add more threads on machines with more cores.
+		threadCounts.push_back(count); // Add the number of threads.
+	}
+	cout << "--- concurrent throughput on " << thread::hardware_concurrency() << " hardware threads (million operations per second) ---" << endl; // Print the case being measured.
+	for (int readPercent : { 100, 90, 50 }) { // Loop through the read ratios.
+		for (int count : threadCounts) { // Loop through the numbers of threads.
+			double concurrent = measureConcurrentThroughput<ConcurrentBinarySearchTree>(count, readPercent, keys); // Measure the concurrent tree.
+			double locked = measureConcurrentThroughput<LockedBinarySearchTree>(count, readPercent, keys); // Measure the tree behind one mutex.
+			cout << readPercent << "% reads, " << count << " threads: concurrent " << setprecision(3) << concurrent << ", mutex " << locked << endl; // Print both throughputs.
+		}
+	}
+}
+
+static void compareParallelOperations() { // This function compares the operations that run on a task pool with the same operations on one thread.
+	for (int count : { 1000000, 10000000 }) { // Loop through the number of keys. 50 million keys need about 10 GB for the two trees, their copies and the key lists.
+		BinarySearchTree first(BalanceMode::AVL); // Create the first tree.
+		BinarySearchTree second(BalanceMode::AVL); // Create the second tree.
+		{
+			vector<string> keys; // Create a vector to store the keys.
+			for (int i = 0; i < count; ++i) { // Loop through the keys of the first tree.
+				keys.push_back(makeSortedKey(i)); // Add the key to the vector.
+			}
+			first.bulkLoad(keys.begin(), keys.end()); // Build the first tree.
+			for (int i = 0; i < count; ++i) { // Loop through the keys of the second tree, which shares half of its keys with the first.
+				keys[i] = makeSortedKey(count / 2 + i); // Replace the key.
+			}
+			second.bulkLoad(keys.begin(), keys.end()); // Build the second tree.
+		}
+		TaskPool serial(1); // Create a pool with one thread, which runs the same code without splitting it.
+		TaskPool& parallel = TaskPool::shared(); // Use the shared pool, which has one thread per hardware thread.
+		cout << "--- " << count << " keys, 1 thread vs " << parallel.threadCount() << " threads ---" << endl; // Print the case being measured.
+		auto measure = [](const char* label, auto operation, TaskPool& one, TaskPool& many) { // Create a function that runs the operation on both pools and prints both times.
+			auto start = high_resolution_clock::now(); // Start measuring time.
+			operation(one); // Run the operation on one thread.
+			duration<double> serialTime = high_resolution_clock::now() - start; // Calculate the time taken on one thread.
+			start = high_resolution_clock::now(); // Start measuring time again.
+			operation(many); // Run the operation on all threads.
+			duration<double> parallelTime = high_resolution_clock::now() - start; // Calculate the time taken on all threads.
+			cout << label << ": " << setprecision(3) << serialTime.count() << " s vs " << parallelTime.count() << " s (" << setprecision(2) << serialTime.count() / parallelTime.count() << "x)" << endl; // Print both times and the speedup.
+		};
+		BinarySearchTree result(BalanceMode::AVL); // Create a tree to store the results.
+		result.assign(first); // Fill the tree once, so both measurements reuse its nodes instead of only the second one.
+		size_t found = 0; // Create a counter for the results, so the operations cannot be optimized away.
+		measure("copy", [&](TaskPool& tasks) { result.assign(first, tasks); found += result.size(); }, serial, parallel); // Measure the copy.
+		measure("equals", [&](TaskPool& tasks) { found += result.equals(first, tasks) ? 1 : 0; }, serial, parallel); // Measure the comparison of two equal trees.
+		measure("union", [&](TaskPool& tasks) { result.assignUnion(first, second, tasks); found += result.size(); }, serial, parallel); // Measure the union.
+		measure("intersection", [&](TaskPool& tasks) { result.assignIntersection(first, second, tasks); found += result.size(); }, serial, parallel); // Measure the intersection.
+		measure("difference", [&](TaskPool& tasks) { result.assignDifference(first, second, tasks); found += result.size(); }, serial, parallel); // Measure the difference.
+		measure("countIf", [&](TaskPool& tasks) { found += first.countIf([](string_view key) { return key.back() == '7'; }, tasks); }, serial, parallel); // Measure the parallel count.
+		assert(found > 0); // Use the counter.
+	}
+}
+
+static void compareRestart() { // This function measures how long it takes to get a tree back after a restart, from a text file and from a saved snapshot.
+	mt19937 gen(17); // Create a random number generator with a fixed seed.
+	BinarySearchTree bst(BalanceMode::AVL); // Create a new balanced binary search tree.
+	vector<string> words; // Create a vector to store the words.
+	for (int i = 0; i < 1000000; ++i) { // Loop through a million words.
+		words.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+	}
+	bst.bulkLoad(words.begin(), words.end()); // Build the tree from the words.
+	string textFile = (filesystem::temp_directory_path() / "bst_restart_words.txt").string(); // Create a path for the text file.
+	string snapshotFile = (filesystem::temp_directory_path() / "bst_restart_words.bin").string(); // Create a path for the snapshot file.
+	{
+		ofstream file(textFile, ios::binary); // Open the text file for writing.
+		file << bst; // Write the words, one per line.
+	}
+	bst.saveSnapshot(snapshotFile); // Write the snapshot.
+	shuffle(words.begin(), words.end(), gen); // Look the words up in a different order than they were written.
+	words.resize(100000); // Use the first words as probes.
+
+	cout << "--- restart with " << bst.size() << " words ---" << endl; // Print the case being measured.
+	auto start = high_resolution_clock::now(); // Start measuring time.
+	BinarySearchTree fromText(BalanceMode::AVL); // Create a tree to load the text file into.
+	fromText.bulkLoadFile(textFile); // Load the text file.
+	duration<double> textTime = high_resolution_clock::now() - start; // Calculate the time taken to load the text file.
+	start = high_resolution_clock::now(); // Start measuring time again.
+	BinarySearchTree fromSnapshot(BalanceMode::AVL); // Create a tree to load the snapshot into.
+	fromSnapshot.loadSnapshot(snapshotFile); // Load the snapshot.
+	duration<double> snapshotTime = high_resolution_clock::now() - start; // Calculate the time taken to load the snapshot.
+	start = high_resolution_clock::now(); // Start measuring time again.
+	FrozenBinarySearchTree mapped; // Create an empty snapshot.
+	mapped.open(snapshotFile); // Map the snapshot.
+	duration<double> mapTime = high_resolution_clock::now() - start; // Calculate the time taken to map the snapshot.
+	size_t found = 0; // Create a counter for the words that were found.
+	start = high_resolution_clock::now(); // Start measuring time again.
+	for (const string& word : words) { // Loop through the probes.
+		found += mapped.exists(word) ? 1 : 0; // Look the word up in the mapped snapshot.
+	}
+	duration<double> firstLookups = high_resolution_clock::now() - start; // Calculate the time taken by the first lookups, which also page the file in.
+	assert(found == words.size() && fromText.size() == bst.size() && fromSnapshot.size() == bst.size()); // Check that every restart gave the full tree.
+	cout << "bulkLoadFile: " << setprecision(3) << textTime.count() << " s, loadSnapshot: " << snapshotTime.count() << " s, open snapshot: " << setprecision(6) << mapTime.count() << " s" << endl; // Print the time taken by each restart.
+	cout << "First " << words.size() << " lookups in the mapped snapshot: " << setprecision(3) << firstLookups.count() << " s" << endl; // Print the time taken by the first lookups.
+	filesystem::remove(textFile); // Delete the text file.
+	filesystem::remove(snapshotFile); // Delete the snapshot file.
+}
+
+static void compareFrozenLookups() { // This function measures node memory and lookup time for a word list, in the pointer tree and in the frozen snapshot.
+	for (int count : { 1000000, 10000000 }) { // Loop through the number of words.
+		mt19937 gen(7); // Create a random number generator with a fixed seed.
+		vector<string> words; // Create a vector to store the words.
+		for (int i = 0; i < count; ++i) { // Loop through the number of words.
+			words.push_back(makeRandomWord(gen)); // Add a random word to the vector.
+		}
+		BinarySearchTree bst(BalanceMode::AVL); // Create a new balanced binary search tree.
+		for (const string& word : words) { // Loop through the words.
+			bst.insert(word); // Insert the word into the tree.
+		}
+		FrozenBinarySearchTree frozen = bst.freeze(); // Build the read-only snapshot of the tree.
+		shuffle(words.begin(), words.end(), gen); // Look the words up in a different order than they were inserted.
+		cout << "--- " << count << " random words ---" << endl; // Print the case being measured.
+		cout << "Node size: " << sizeof(Node) << " bytes, key pool: " << setprecision(2) << double(bst.keyBytes()) / bst.size() << " bytes per key" << endl; // Print the memory used per node.
+		cout << "Frozen size: " << setprecision(2) << double(frozen.memoryBytes()) / frozen.size() << " bytes per key" << endl; // Print the memory used per key by the snapshot.
+		double allocations = 0; // Create a variable to store the number of allocations per lookup.
+		double time = measureLookupPerformance(bst, words, allocations); // Measure the average lookup time in the pointer tree.
+		cout << "Lookup time: " << setprecision(1) << time << " ns per exists (" << setprecision(3) << allocations << " allocations per lookup)" << endl; // Print the average lookup time.
+		double frozenTime = measureLookupPerformance(frozen, words, allocations); // Measure the average lookup time in the snapshot.
+		cout << "Frozen lookup time: " << setprecision(1) << frozenTime << " ns per exists (" << setprecision(2) << time / frozenTime << "x faster)" << endl; // Print the average lookup time in the snapshot.
+	}
+}
+
+static void compareIntegerKeys() { // This function compares a tree of numeric ids stored as strings with a typed tree that stores the ids as integers.
+	const int count = 1000000; // Define the number of ids.
+	mt19937_64 gen(11); // Create a random number generator with a fixed seed.
+	vector<uint64_t> ids; // Create a vector to store the ids.
+	for (int i = 0; i < count; ++i) { // Loop through the number of ids.
+		ids.push_back(gen()); // Add a random id to the vector.
+	}
+	auto start = high_resolution_clock::now(); // Start measuring time.
+	BinarySearchTree stringTree(BalanceMode::AVL); // Create a new balanced tree of strings.
+	for (uint64_t id : ids) { // Loop through the ids.
+		stringTree.insert(to_string(id)); // Insert the id as text, which is how numeric keys were stored before.
+	}
+	duration<double> stringInsert = high_resolution_clock::now() - start; // Calculate the time taken, including the formatting of the keys.
+	start = high_resolution_clock::now(); // Start measuring time again.
+	TypedBinarySearchTree<uint64_t> integerTree(BalanceMode::AVL); // Create a new balanced tree of integers.
+	for (uint64_t id : ids) { // Loop through the ids.
+		integerTree.insert(id); // Insert the id as it is.
+	}
+	duration<double> integerInsert = high_resolution_clock::now() - start; // Calculate the time taken.
+	assert(stringTree.size() == integerTree.size()); // Both trees hold the same ids.
+	shuffle(ids.begin(), ids.end(), gen); // Look the ids up in a different order than they were inserted.
+	vector<string> probes; // Create a vector to store the ids as text, so formatting is not part of the lookup time.
+	for (uint64_t id : ids) { // Loop through the ids.
+		probes.push_back(to_string(id)); // Add the id as text.
+	}
+	double allocations = 0; // Create a variable to store the number of allocations per lookup.
+	double stringLookup = measureLookupPerformance(stringTree, probes, allocations); // Measure the average lookup time in the string tree.
+	size_t found = 0; // Create a counter for the ids found, so the lookups cannot be optimized away.
+	start = high_resolution_clock::now(); // Start measuring time.
+	for (uint64_t id : ids) { // Loop through the ids.
+		found += integerTree.exists(id) ? 1 : 0; // Look the id up.
+	}
+	duration<double, nano> integerLookup = high_resolution_clock::now() - start; // Calculate the time taken for all lookups.
+	assert(found == ids.size()); // Every id was inserted, so every lookup hits.
+	cout << "--- " << count << " random 64-bit ids ---" << endl; // Print the case being measured.
+	cout << "Node size: " << sizeof(Node) << " bytes + " << setprecision(3) << double(stringTree.keyBytes()) / stringTree.size() << " key bytes (string), " << sizeof(TypedNode<uint64_t, void>) << " bytes (integer)" << endl; // Print the memory used per key.
+	cout << "Insert time: " << setprecision(3) << stringInsert.count() << " s (string), " << integerInsert.count() << " s (integer, " << setprecision(2) << stringInsert.count() / integerInsert.count() << "x faster)" << endl; // Print the time taken to build the trees.
+	cout << "Lookup time: " << setprecision(1) << stringLookup << " ns (string), " << integerLookup.count() / ids.size() << " ns (integer, " << setprecision(2) << stringLookup * ids.size() / integerLookup.count() << "x faster)" << endl; // Print the average lookup time.
+}
+
+void runComparisons() { // This function runs every comparison and prints its results.
+	compareAllocators(); // Compare the node allocators.
+	compareLoading(); // Compare bulk loading and batched inserts with single inserts.
+	compareTraversals(); // Measure the ways of visiting every key of a large tree.
+	compareConcurrentThroughput(); // Measure how the concurrent tree scales with the number of threads, compared with a tree behind one mutex.
+	compareParallelOperations(); // Compare the operations that run on a task pool with the same operations on one thread.
+	compareRestart(); // Measure how long it takes to get a tree back after a restart, from a text file and from a saved snapshot.
+	compareFrozenLookups(); // Measure node memory and lookup time for a word list, in the pointer tree and in the frozen snapshot.
+	compareIntegerKeys(); // Compare a tree of numeric ids stored as strings with a typed tree that stores the ids as integers.
+}
@@ -0,0 +1,9 @@
+/*
+This header file declares the comparison benchmarks that used to run at the end of the test program. Each one measures one design choice against
+its alternative, such as the node allocators, bulk loading against single inserts or the concurrent tree against a tree behind one mutex, and prints
+the numbers side by side instead of adding them to the workload report.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+
+void runComparisons(); // This function runs every comparison and prints its results.
@@ -0,0 +1,150 @@
+/*
+This implementation file provides the implementations for the key distributions declared in the header file. Random keys come from a bijective mix
+of their index, so they are distinct without a set to check them against, and the Zipf chooser draws ranks by binary search in a cumulative table.
+*/
+
+#include "KeyDistribution.h" // This is a header file that contains the declaration of the key distributions.
+#include <algorithm> // This is a header file library that lets us use algorithms such as shuffle and upper_bound.
+#include <cmath> // This is a header file library that lets us use math functions such as pow.
+#include <fstream> // This is a header file library that lets us work with files.
+
+static uint64_t mix(uint64_t value) { // This function scrambles the bits of a number. Every input gives a different output, so distinct indexes give distinct keys.
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL; // Mix the high bits into the low bits.
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL; // Mix again with another odd constant.
+	return value ^ (value >> 31); // Mix the low bits back into the high bits.
+}
+
+static string makeRandomKey(uint64_t index, uint64_t seed) { // This function creates the random key with the given index, as 16 hexadecimal digits.
+	static const char digits[] = "0123456789abcdef"; // Define the hexadecimal digits.
+	uint64_t value = mix(seed * 0x9E3779B97F4A7C15ULL + index); // Scramble the index. Different indexes of the same seed never collide.
+	string key(16, '0'); // Create a key of 16 digits.
+	for (int i = 15; i >= 0; --i) { // Loop through the digits from the last one.
+		key[i] = digits[value & 15]; // Store the lowest four bits as a digit.
+		value >>= 4; // Move on to the next four bits.
+	}
+	return key; // Return the key.
+}
+
+string distributionName(Distribution distribution) { // This function returns the name of the distribution, as used on the command line and in reports.
+	switch (distribution) { // Check the distribution.
+	case Distribution::Uniform: return "uniform"; // Random keys, uniform lookups.
+	case Distribution::Sorted: return "sorted"; // Increasing keys.
+	case Distribution::Zipf: return "zipf"; // Random keys, skewed lookups.
+	default: return "words"; // The lines of a word list.
+	}
+}
+
+bool parseDistribution(const string& name, Distribution& distribution) { // This function finds the distribution with the given name. It returns false if there is none.
+	for (Distribution candidate : { Distribution::Uniform, Distribution::Sorted, Distribution::Zipf, Distribution::Words }) { // Loop through the distributions.
+		if (distributionName(candidate) == name) { // If the name matches, use the distribution.
+			distribution = candidate; // Store the distribution.
+			return true; // Return true to indicate that the name was found.
+		}
+	}
+	return false; // Return false to indicate that the name is unknown.
+}
+
+string makeSortedKey(uint64_t value) { // This function turns a number into a zero-padded string, so increasing numbers give increasing strings.
+	string key = to_string(value); // Convert the number to a string.
+	if (key.size() < 12) { // If the string is shorter than twelve characters, pad it, so every benchmark size keeps the order.
+		key.insert(0, 12 - key.size(), '0'); // Add leading zeros to the string.
+	}
+	return key; // Return the padded string.
+}
+
+string makeRandomWord(mt19937& gen) { // This function creates a random lowercase word of 3 to 14 letters.
+	uniform_int_distribution<> lengthDis(3, 14); // Create a uniform distribution for the word length.
+	uniform_int_distribution<> letterDis('a', 'z'); // Create a uniform distribution for the letters.
+	string word(lengthDis(gen), ' '); // Create a word with a random length.
+	for (char& letter : word) { // Loop through the letters of the word.
+		letter = static_cast<char>(letterDis(gen)); // Pick a random letter.
+	}
+	return word; // Return the word.
+}
+
+bool loadWordList(const string& filename, vector<string>& words) { // This function reads the distinct lines of a file. It returns false if the file cannot be opened or is empty.
+	ifstream file(filename); // Open the file.
+	if (!file) { // If the file cannot be opened, there are no words.
+		return false; // Return false to indicate the failure.
+	}
+	string line; // Create a string to store each line.
+	while (getline(file, line)) { // Read the file one line at a time.
+		if (!line.empty() && line.back() == '\r') { // If the line ends with a carriage return, it came from a Windows file.
+			line.pop_back(); // Remove the carriage return.
+		}
+		if (!line.empty()) { // Skip empty lines.
+			words.push_back(line); // Store the word.
+		}
+	}
+	sort(words.begin(), words.end()); // Sort the words, so duplicates are next to each other.
+	words.erase(unique(words.begin(), words.end()), words.end()); // Remove the duplicates.
+	return !words.empty(); // Return true if the file had any words.
+}
+
+KeySet makeKeySet(Distribution distribution, size_t count, size_t extraMissing, uint64_t seed, const vector<string>& words) { // This function creates count present keys and count plus extraMissing missing keys for the distribution.
+	KeySet keys; // Create the key set.
+	size_t missingCount = count + extraMissing; // There is one missing key per present key for failed lookups, and more for the inserts of mixed workloads.
+	keys.present.reserve(count); // Make room for the present keys.
+	keys.missing.reserve(missingCount); // Make room for the missing keys.
+	if (distribution == Distribution::Sorted) { // Sorted keys are the even numbers, and the odd numbers fall between them.
+		for (size_t i = 0; i < count; ++i) { // Loop through the present keys.
+			keys.present.push_back(makeSortedKey(2 * i)); // Add the even number, in increasing order.
+		}
+		for (size_t i = 0; i < missingCount; ++i) { // Loop through the missing keys.
+			keys.missing.push_back(makeSortedKey(2 * i + 1)); // Add the odd number, in increasing order, so inserts keep coming at the right end.
+		}
+		return keys; // Return the keys.
+	}
+	if (distribution == Distribution::Words) { // Word lists use the words as they are, in random order.
+		vector<string> shuffled = words; // Create a copy of the words to shuffle.
+		shuffle(shuffled.begin(), shuffled.end(), mt19937_64(seed)); // Shuffle the words with the seed.
+		shuffled.resize(min(count, shuffled.size())); // Use as many words as the case asks for, or all of them.
+		keys.present = move(shuffled); // Store the words.
+		for (size_t i = 0; i < missingCount; ++i) { // Loop through the missing keys.
+			const string& word = keys.present[i % keys.present.size()]; // Base the key on a word, so it looks like the other keys.
+			keys.missing.push_back(word + "#" + to_string(i / keys.present.size())); // Add a suffix no word has, which keeps the keys distinct.
+		}
+		return keys; // Return the keys.
+	}
+	for (size_t i = 0; i < count; ++i) { // Random keys come from the first indexes,
+		keys.present.push_back(makeRandomKey(i, seed)); // and are inserted in the scrambled order.
+	}
+	for (size_t i = 0; i < missingCount; ++i) { // Missing keys come from the indexes after them,
+		keys.missing.push_back(makeRandomKey(count + i, seed)); // so they can never be present keys.
+	}
+	return keys; // Return the keys.
+}
+
+KeyChooser::KeyChooser(size_t count, bool zipf, uint64_t seed, double skew) : gen(seed), count(count) { // This is a constructor for a chooser over count keys.
+	if (!zipf || count == 0) { // Uniform choices need no table.
+		return; // Return without building the table.
+	}
+	cumulative.resize(count); // Make room for the probability of every rank.
+	double total = 0; // Create a variable to store the sum of the weights.
+	for (size_t rank = 0; rank < count; ++rank) { // Loop through the ranks.
+		total += 1.0 / pow(double(rank + 1), skew); // The weight of a rank falls with a power of the rank.
+		cumulative[rank] = total; // Store the sum of the weights so far.
+	}
+	for (double& value : cumulative) { // Loop through the sums.
+		value /= total; // Turn the sums into probabilities.
+	}
+	rankToIndex.resize(count); // Make room for the mapping from ranks to keys.
+	for (size_t i = 0; i < count; ++i) { // Loop through the keys.
+		rankToIndex[i] = i; // Start with every rank mapped to the key with the same index.
+	}
+	shuffle(rankToIndex.begin(), rankToIndex.end(), gen); // Shuffle the mapping, so sorted keys do not put all popular keys at one end.
+}
+
+size_t KeyChooser::nextRank() { // This function returns the next Zipf rank, where rank 0 is the most popular, without mapping it to a key.
+	if (cumulative.empty()) { // Uniform choices pick every index with the same probability.
+		return uniform_int_distribution<size_t>(0, count - 1)(gen); // Pick an index.
+	}
+	double point = uniform_real_distribution<double>(0.0, 1.0)(gen); // Pick a point in the cumulative probabilities.
+	size_t rank = upper_bound(cumulative.begin(), cumulative.end(), point) - cumulative.begin(); // Find the rank the point falls into.
+	return min(rank, count - 1); // Keep the rank in range, in case rounding left the last sum slightly below 1.
+}
+
+size_t KeyChooser::next() { // This function returns the index of the next key.
+	size_t rank = nextRank(); // Pick a rank.
+	return rankToIndex.empty() ? rank : rankToIndex[rank]; // Map the rank to a key.
+}
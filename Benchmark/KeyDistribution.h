@@ -0,0 +1,45 @@
+/*
+This header file defines the key distributions the benchmark builds its trees from and the patterns it picks keys with. Every generator takes a seed,
+so two runs with the same options insert, look up and remove exactly the same keys in the same order, and their results can be compared.
+*/
+
+#pragma once // This is a header guard. It prevents the header file from being included more than once in the same file.
+#include <cstddef> // This is a header file library that lets us work with sizes, such as size_t.
+#include <cstdint> // This is a header file library that lets us work with fixed-width integers, such as uint64_t.
+#include <random> // This is a header file library that lets us work with random numbers.
+#include <string> // This is a header file library that lets us work with strings.
+#include <vector> // This is a header file library that lets us work with arrays that can change in size.
+
+using namespace std; // using standard namespace to avoid writing std:: before standard library functions
+
+enum class Distribution { // This enum selects which keys the benchmark uses and in which order it inserts them.
+	Uniform, // Random keys, inserted in random order and looked up uniformly.
+	Sorted, // Increasing keys, inserted in sorted order and looked up uniformly.
+	Zipf, // Random keys, inserted in random order and looked up with a Zipf skew, so a few keys get most of the lookups.
+	Words // The lines of a word list, inserted in random order and looked up uniformly.
+};
+
+struct KeySet { // This struct stores the keys of one benchmark case.
+	vector<string> present; // This vector stores the keys that are inserted, in insertion order.
+	vector<string> missing; // This vector stores keys that are never in the tree at first, for failed lookups and for inserts during mixed workloads.
+};
+
+string distributionName(Distribution distribution); // This function returns the name of the distribution, as used on the command line and in reports.
+bool parseDistribution(const string& name, Distribution& distribution); // This function finds the distribution with the given name. It returns false if there is none.
+string makeSortedKey(uint64_t value); // This function turns a number into a zero-padded string, so increasing numbers give increasing strings.
+string makeRandomWord(mt19937& gen); // This function creates a random lowercase word of 3 to 14 letters.
+bool loadWordList(const string& filename, vector<string>& words); // This function reads the distinct lines of a file. It returns false if the file cannot be opened or is empty.
+KeySet makeKeySet(Distribution distribution, size_t count, size_t extraMissing, uint64_t seed, const vector<string>& words); // This function creates count present keys and count plus extraMissing missing keys for the distribution.
+
+class KeyChooser { // This class picks indexes of keys for lookups, either uniformly or with a Zipf skew.
+private: // This section contains private members of the class.
+	mt19937_64 gen; // This generator provides the random numbers.
+	size_t count; // This number stores how many keys there are to choose from.
+	vector<double> cumulative; // This vector stores the cumulative probability of every rank for the Zipf skew. It is empty for uniform choices.
+	vector<size_t> rankToIndex; // This vector maps every Zipf rank to a key, so the popular keys are spread over the whole tree.
+
+public: // This section contains public members of the class.
+	KeyChooser(size_t count, bool zipf, uint64_t seed, double skew = 0.99); // This is a constructor for a chooser over count keys. YCSB uses a skew of 0.99.
+	size_t next(); // This function returns the index of the next key.
+	size_t nextRank(); // This function returns the next Zipf rank, where rank 0 is the most popular, without mapping it to a key.
+};